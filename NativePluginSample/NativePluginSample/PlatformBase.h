@@ -1,3 +1,4 @@
 #pragma once
 
-#define SUPPORT_VULKAN 1
\ No newline at end of file
+#define SUPPORT_VULKAN 1
+#define SUPPORT_SOFTWARE_RASTERIZER 1
\ No newline at end of file
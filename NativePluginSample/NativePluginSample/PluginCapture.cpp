@@ -0,0 +1,208 @@
+#include "PluginCapture.h"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <unordered_set>
+
+// Main thread (SetTimeFromUnity, bindless calls) and render thread (render events) both write,
+// records keep the order in which they reached the plugin
+static std::mutex s_Mutex;
+// Checked before taking the lock, so render events stay cheap while no capture is running
+static std::atomic<bool> s_Active = false;
+static std::ofstream s_File;
+static std::vector<char> s_FileBuffer;
+static std::unordered_set<uint64_t> s_SeenRenderPasses;
+static uint64_t s_LastFrameNumber = 0;
+static uint64_t s_LastRenderPass = 0;
+static int s_LastSubpassIndex = -1;
+static bool s_HasLastInputs = false;
+static float s_LastTime = 0.0f;
+static int s_LastMaterial = -1;
+
+template<typename T>
+static void Write(const T& value)
+{
+	s_File.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void WriteRecordType(CaptureRecordType type)
+{
+	Write<uint8_t>(type);
+}
+
+bool PluginCapture::Begin(const char* path)
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (s_File.is_open())
+		return false;
+
+	s_File.open(path, std::ios::binary | std::ios::trunc);
+	if (!s_File.is_open())
+		return false;
+
+	// Render events arrive at a high rate, batch them into large writes.
+	// Set after open and before the first write, MSVC's filebuf ignores a buffer set while no file is attached.
+	s_FileBuffer.resize(1 << 20);
+	s_File.rdbuf()->pubsetbuf(s_FileBuffer.data(), static_cast<std::streamsize>(s_FileBuffer.size()));
+
+	s_SeenRenderPasses.clear();
+	s_LastFrameNumber = 0;
+	s_LastRenderPass = 0;
+	s_LastSubpassIndex = -1;
+	s_HasLastInputs = false;
+
+	Write(kCaptureMagic);
+	Write(kCaptureVersion);
+	s_Active = true;
+	return true;
+}
+
+void PluginCapture::End()
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	s_Active = false;
+	s_File.close();
+}
+
+bool PluginCapture::IsActive()
+{
+	return s_Active;
+}
+
+void PluginCapture::RecordDeviceEvent(int eventType)
+{
+	if (!s_Active)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	WriteRecordType(kCaptureDeviceEvent);
+	Write<int32_t>(eventType);
+}
+
+void PluginCapture::RecordRenderEvent(int eventID, float time, int materialHandle)
+{
+	if (!s_Active)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	// The main thread sets these up to a frame ahead of the render thread, so record the values this event ran with
+	if (!s_HasLastInputs || time != s_LastTime)
+	{
+		WriteRecordType(kCaptureTime);
+		Write(time);
+		s_LastTime = time;
+	}
+	if (!s_HasLastInputs || materialHandle != s_LastMaterial)
+	{
+		WriteRecordType(kCaptureMaterial);
+		Write<int32_t>(materialHandle);
+		s_LastMaterial = materialHandle;
+	}
+	s_HasLastInputs = true;
+
+	WriteRecordType(kCaptureRenderEvent);
+	Write<int32_t>(eventID);
+}
+
+void PluginCapture::RecordBindlessBuffer(int handle, const void* data, uint32_t sizeInBytes)
+{
+	if (!s_Active)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	WriteRecordType(kCaptureBindlessBuffer);
+	Write<int32_t>(handle);
+	Write(sizeInBytes);
+	s_File.write(static_cast<const char*>(data), sizeInBytes);
+}
+
+void PluginCapture::RecordBindlessTexture(int handle)
+{
+	if (!s_Active)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	WriteRecordType(kCaptureBindlessTexture);
+	Write<int32_t>(handle);
+}
+
+void PluginCapture::RecordBindlessRelease(uint8_t type, int handle)
+{
+	if (!s_Active)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	WriteRecordType(kCaptureBindlessRelease);
+	Write(type);
+	Write<int32_t>(handle);
+}
+
+void PluginCapture::RecordRecordingState(uint64_t frameNumber, const CapturedRenderPass& renderPass, int subpassIndex)
+{
+	if (!s_Active)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (!s_File.is_open())
+		return;
+
+	if (frameNumber != s_LastFrameNumber)
+	{
+		WriteRecordType(kCaptureFrame);
+		Write(frameNumber);
+		s_LastFrameNumber = frameNumber;
+	}
+
+	if (s_SeenRenderPasses.insert(renderPass.id).second)
+	{
+		WriteRecordType(kCaptureRenderPass);
+		Write(renderPass.id);
+		Write(static_cast<uint32_t>(renderPass.attachments.size()));
+		for (const CapturedRenderPass::Attachment& attachment : renderPass.attachments)
+		{
+			Write(attachment.format);
+			Write(attachment.samples);
+		}
+		Write(static_cast<uint32_t>(renderPass.subpasses.size()));
+		for (const CapturedRenderPass::Subpass& subpass : renderPass.subpasses)
+		{
+			Write(static_cast<uint32_t>(subpass.colorAttachments.size()));
+			for (uint32_t colorAttachment : subpass.colorAttachments)
+				Write(colorAttachment);
+			Write(subpass.depthAttachment);
+			Write(static_cast<uint32_t>(subpass.inputAttachments.size()));
+			for (uint32_t inputAttachment : subpass.inputAttachments)
+				Write(inputAttachment);
+			Write(static_cast<uint32_t>(subpass.resolveAttachments.size()));
+			for (uint32_t resolveAttachment : subpass.resolveAttachments)
+				Write(resolveAttachment);
+		}
+	}
+
+	if (renderPass.id != s_LastRenderPass || subpassIndex != s_LastSubpassIndex)
+	{
+		WriteRecordType(kCaptureRecordingState);
+		Write(renderPass.id);
+		Write<int32_t>(subpassIndex);
+		s_LastRenderPass = renderPass.id;
+		s_LastSubpassIndex = subpassIndex;
+	}
+}
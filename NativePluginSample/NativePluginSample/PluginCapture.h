@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Binary capture of everything that crosses the plugin boundary, replayed by PluginReplay.
+// Little-endian, unpadded. The file starts with kCaptureMagic and kCaptureVersion (uint32 each),
+// followed by records made of a uint8 CaptureRecordType and its payload.
+static const uint32_t kCaptureMagic = 0x43504E55; // "UNPC"
+static const uint32_t kCaptureVersion = 2;
+
+enum CaptureRecordType : uint8_t
+{
+	kCaptureDeviceEvent = 1,		// int32 UnityGfxDeviceEventType
+	kCaptureTime = 2,				// float, SetTimeFromUnity value the following render events ran with
+	kCaptureMaterial = 3,			// int32, SetMaterialFromUnity value the following render events ran with
+	kCaptureRenderEvent = 4,		// int32 event ID
+	kCaptureFrame = 5,				// uint64 frame number, written when the render thread starts recording a new frame
+	kCaptureRenderPass = 6,			// CapturedRenderPass, written the first time a render pass is seen
+	kCaptureRecordingState = 7,		// uint64 render pass ID, int32 subpass index, written when it changes
+	kCaptureBindlessBuffer = 8,		// int32 handle, uint32 size, payload bytes
+	kCaptureBindlessTexture = 9,	// int32 handle, the Unity texture itself cannot be captured
+	kCaptureBindlessRelease = 10,	// uint8 BindlessResourceType, int32 handle
+};
+
+// Render pass layout as seen in vkCreateRenderPass, enough to recreate a compatible render pass on replay.
+// Serialized as uint64 ID, uint32 attachment count, {uint32 format, uint32 samples} per attachment,
+// uint32 subpass count, then per subpass: uint32 color count, uint32 color attachment per color, uint32 depth attachment,
+// uint32 input count, uint32 input attachment per input, uint32 resolve count (0 or the color count), uint32 resolve attachment per resolve.
+struct CapturedRenderPass
+{
+	struct Attachment
+	{
+		uint32_t format;
+		uint32_t samples;
+	};
+
+	struct Subpass
+	{
+		std::vector<uint32_t> colorAttachments;
+		uint32_t depthAttachment; // VK_ATTACHMENT_UNUSED if none
+		std::vector<uint32_t> inputAttachments;
+		std::vector<uint32_t> resolveAttachments; // empty, or one per color attachment with VK_ATTACHMENT_UNUSED for no resolve
+	};
+
+	uint64_t id;
+	std::vector<Attachment> attachments;
+	std::vector<Subpass> subpasses;
+};
+
+class PluginCapture
+{
+public:
+	PluginCapture() = delete;
+
+	static bool Begin(const char* path);
+	static void End();
+	static bool IsActive();
+
+	static void RecordDeviceEvent(int eventType);
+	// Time and material are written along with the event whenever they changed since the previous one
+	static void RecordRenderEvent(int eventID, float time, int materialHandle);
+	static void RecordBindlessBuffer(int handle, const void* data, uint32_t sizeInBytes);
+	static void RecordBindlessTexture(int handle);
+	static void RecordBindlessRelease(uint8_t type, int handle);
+
+	// Called from the graphics API implementation before it records commands for a render event.
+	// Writes frame, render pass and recording state records only when they changed since the previous event.
+	static void RecordRecordingState(uint64_t frameNumber, const CapturedRenderPass& renderPass, int subpassIndex);
+};
@@ -11,6 +11,15 @@ RenderAPI* CreateRenderAPI(UnityGfxRenderer apiType)
 	}
 #endif // if SUPPORT_VULKAN
 
+#if SUPPORT_SOFTWARE_RASTERIZER
+	// No graphics device, e.g. batchmode with -nographics
+	if (apiType == kUnityGfxRendererNull)
+	{
+		extern RenderAPI* CreateRenderAPI_Software();
+		return CreateRenderAPI_Software();
+	}
+#endif // if SUPPORT_SOFTWARE_RASTERIZER
+
 	// Unknown or unsupported graphics API
 	return nullptr;
 }
@@ -2,6 +2,29 @@
 
 #include <IUnityGraphics.h>
 
+// Bindless resource kinds, each has its own handle space
+enum BindlessResourceType
+{
+	kBindlessTexture = 0,
+	kBindlessBuffer = 1,
+	kBindlessResourceTypeCount
+};
+
+// Device memory of one heap in bytes, see GetMemoryBudget
+struct MemoryHeapBudget
+{
+	unsigned long long size;
+	// What this process may allocate from the heap, the heap size without VK_EXT_memory_budget
+	unsigned long long budget;
+	// Whole process including Unity, only plugin allocations without VK_EXT_memory_budget
+	unsigned long long processUsage;
+	unsigned long long pluginUsage;
+	// Streamable plugin resources are evicted above this
+	unsigned long long pluginLimit;
+	int deviceLocal;
+	int driverBudget; // budget and processUsage come from VK_EXT_memory_budget
+};
+
 class RenderAPI
 {
 public:
@@ -15,6 +38,39 @@ public:
 	virtual bool GetUsesReverseZ() = 0;
 
 	virtual void DrawColoredTriangle() = 0;
+
+	// Measure the CPU cost of recording draw commands and log the result.
+	virtual void BenchmarkCommandRecording() {}
+
+	// Bindless resources are addressed in shaders by integer handles, -1 means the API has no bindless support.
+	// Texture and buffer handles are separate index spaces.
+	virtual int CreateBindlessBuffer(const void* data, int sizeInBytes) { return -1; }
+	virtual int RegisterBindlessTexture(void* nativeTexture) { return -1; }
+	virtual void ReleaseBindlessBuffer(int handle) {}
+	virtual void ReleaseBindlessTexture(int handle) {}
+
+	// Apply pending bindless texture registrations and recycle released handles. Must run outside of a render pass.
+	virtual void UpdateBindlessTable() {}
+
+	// Streamable buffers keep a CPU copy and may lose their device memory under memory pressure, least recently used first.
+	// Touch them every frame they are used, evicted ones are uploaded again by the first render event of the next frame.
+	// Evicted slots read a small zero-filled buffer, shaders must not draw with handles that are not resident.
+	virtual int CreateStreamableBindlessBuffer(const void* data, int sizeInBytes) { return -1; }
+	virtual void TouchBindlessBuffer(int handle) {}
+	virtual bool IsBindlessBufferResident(int handle) { return false; }
+
+	// Fills one entry per memory heap and returns the number of heaps, 0 when the API does not track memory.
+	virtual int GetMemoryBudget(MemoryHeapBudget* heaps, int maxHeaps) { return 0; }
+	// Share of each heap budget plugin allocations may use before streamable resources are evicted, in [0, 1].
+	virtual void SetMemoryBudgetFraction(float fraction) {}
+
+	// CPU framebuffer of the software rasterizer, RGBA8 rows from top to bottom. Other APIs render into Unity's targets and return false.
+	virtual bool ResizeSoftwareFramebuffer(int width, int height) { return false; }
+	virtual void ClearSoftwareFramebuffer(unsigned int rgba) {}
+	// sizeInBytes must hold width * height * 4 bytes, pending draws are finished first.
+	virtual bool ReadSoftwareFramebuffer(void* pixels, int sizeInBytes) { return false; }
+	// Megapixels rasterized per second per core since the previous call.
+	virtual double GetSoftwareFramebufferThroughput() { return 0.0; }
 };
 
 // Create a graphics API implementation instance for the given API type.
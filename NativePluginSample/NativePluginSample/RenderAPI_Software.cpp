@@ -0,0 +1,109 @@
+#include "RenderAPI_Software.h"
+#include <cmath>
+#include <format>
+#include "RenderingPlugin.h"
+
+RenderAPI_Software::RenderAPI_Software()
+{
+}
+
+void RenderAPI_Software::ProcessDeviceEvent(UnityGfxDeviceEventType type, IUnityInterfaces* interfaces)
+{
+	switch (type)
+	{
+	case kUnityGfxDeviceEventInitialize:
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Rasterizer.Resize(kDefaultFramebufferSize, kDefaultFramebufferSize);
+		UNITY_LOG(RenderingPlugin::UnityLog, std::format("Software rasterizer: {}x{} framebuffer, {} threads", m_Rasterizer.GetWidth(), m_Rasterizer.GetHeight(), m_Rasterizer.GetThreadCount()).c_str());
+		break;
+	}
+	case kUnityGfxDeviceEventShutdown:
+		break;
+	}
+}
+
+void RenderAPI_Software::DrawColoredTriangle()
+{
+	// Transformation matrix: rotate around Z axis based on time, as in RenderAPI_Vulkan::DrawColoredTriangle
+	float phi = RenderingPlugin::EventTime;
+	float cosPhi = cosf(phi);
+	float sinPhi = sinf(phi);
+	float depth = 0.7f;
+	float finalDepth = GetUsesReverseZ() ? 1.0f - depth : depth;
+
+	// Same vertex data as the Vulkan path, colors are read as R8G8B8A8_UNORM
+	struct MyVertex
+	{
+		float x, y, z;
+		unsigned int color;
+	};
+	const MyVertex verts[3] =
+	{
+		{ -0.5f, -0.25f,  0, 0xFFff0000 },
+		{ 0.5f, -0.25f,  0, 0xFF00ff00 },
+		{ 0,     0.5f ,  0, 0xFF0000ff },
+	};
+
+	SoftwareVertex transformed[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		// Column-major matrix of the Vulkan push constant applied to (x, y, z, 1)
+		transformed[i].x = cosPhi * verts[i].x + sinPhi * verts[i].y;
+		transformed[i].y = -sinPhi * verts[i].x + cosPhi * verts[i].y;
+		transformed[i].z = verts[i].z + finalDepth;
+		transformed[i].w = 1.0f;
+		transformed[i].r = (verts[i].color & 0xFF) / 255.0f;
+		transformed[i].g = ((verts[i].color >> 8) & 0xFF) / 255.0f;
+		transformed[i].b = ((verts[i].color >> 16) & 0xFF) / 255.0f;
+		transformed[i].a = (verts[i].color >> 24) / 255.0f;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Rasterizer.DrawTriangles(transformed, 3);
+}
+
+bool RenderAPI_Software::ResizeSoftwareFramebuffer(int width, int height)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (!m_Rasterizer.Resize(width, height))
+	{
+		UNITY_LOG_ERROR(RenderingPlugin::UnityLog, std::format("Software rasterizer: invalid framebuffer size {}x{}", width, height).c_str());
+		return false;
+	}
+	return true;
+}
+
+void RenderAPI_Software::ClearSoftwareFramebuffer(unsigned int rgba)
+{
+	// Reverse-Z, the far plane is at 0
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Rasterizer.Clear(rgba, 0.0f);
+}
+
+bool RenderAPI_Software::ReadSoftwareFramebuffer(void* pixels, int sizeInBytes)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (pixels == nullptr || sizeInBytes < 0 || static_cast<size_t>(sizeInBytes) < static_cast<size_t>(m_Rasterizer.GetWidth()) * m_Rasterizer.GetHeight() * 4)
+		return false;
+
+	m_Rasterizer.ReadColor(pixels);
+	return true;
+}
+
+double RenderAPI_Software::GetSoftwareFramebufferThroughput()
+{
+	uint64_t pixels;
+	double seconds;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Rasterizer.TakeStats(&pixels, &seconds);
+	}
+	// Seconds are summed over threads, so this is per core
+	return seconds > 0.0 ? pixels / seconds * 1e-6 : 0.0;
+}
+
+RenderAPI* CreateRenderAPI_Software()
+{
+	return new RenderAPI_Software();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <mutex>
+#include <IUnityGraphics.h>
+#include "RenderAPI.h"
+#include "SoftwareRasterizer.h"
+
+// CPU implementation used when Unity runs without a graphics device (batchmode -nographics).
+// Draws go into a framebuffer owned by the plugin that C# reads back with ReadSoftwareFramebuffer.
+class RenderAPI_Software : public RenderAPI
+{
+public:
+	static const int kDefaultFramebufferSize = 512;
+
+	RenderAPI_Software();
+	virtual ~RenderAPI_Software() {}
+
+	virtual void ProcessDeviceEvent(UnityGfxDeviceEventType type, IUnityInterfaces* interfaces);
+
+	virtual bool GetUsesReverseZ() { return true; }
+
+	virtual void DrawColoredTriangle();
+
+	virtual bool ResizeSoftwareFramebuffer(int width, int height);
+
+	virtual void ClearSoftwareFramebuffer(unsigned int rgba);
+
+	virtual bool ReadSoftwareFramebuffer(void* pixels, int sizeInBytes);
+
+	virtual double GetSoftwareFramebufferThroughput();
+
+private:
+	// Draws come from the render event, readback and clears from the main thread
+	std::mutex m_Mutex;
+	SoftwareRasterizer m_Rasterizer;
+};
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <IUnityGraphics.h>
-// This plugin does not link to the Vulkan loader, easier to support multiple APIs and systems that don't have Vulkan support
-#define VK_NO_PROTOTYPES
-#include <IUnityGraphicsVulkan.h>
 #include "RenderAPI.h"
+#include "VulkanBindlessTable.h"
+#include "VulkanDispatchTable.h"
+#include "VulkanMemoryBudget.h"
 
 struct VulkanBuffer
 {
@@ -14,6 +18,7 @@ struct VulkanBuffer
 	VkDeviceSize sizeInBytes;
 	VkDeviceSize deviceMemorySize;
 	VkMemoryPropertyFlags deviceMemoryFlags;
+	uint32_t memoryHeapIndex;
 };
 
 class RenderAPI_Vulkan : public RenderAPI
@@ -28,18 +33,111 @@ public:
 
 	virtual void DrawColoredTriangle();
 
+	virtual void BenchmarkCommandRecording();
+
+	virtual int CreateBindlessBuffer(const void* data, int sizeInBytes);
+
+	virtual int CreateStreamableBindlessBuffer(const void* data, int sizeInBytes);
+
+	virtual void TouchBindlessBuffer(int handle);
+
+	virtual bool IsBindlessBufferResident(int handle);
+
+	virtual int RegisterBindlessTexture(void* nativeTexture);
+
+	virtual void ReleaseBindlessBuffer(int handle);
+
+	virtual void ReleaseBindlessTexture(int handle);
+
+	virtual void UpdateBindlessTable();
+
+	virtual int GetMemoryBudget(MemoryHeapBudget* heaps, int maxHeaps);
+
+	virtual void SetMemoryBudgetFraction(float fraction);
+
 private:
+	struct PendingBindlessTexture
+	{
+		int handle;
+		void* nativeTexture;
+	};
+
+	struct PendingBindlessRelease
+	{
+		BindlessResourceType type;
+		int handle;
+		unsigned long long frameNumber; // 0 until stamped by UpdateBindlessTable
+	};
+
+	struct StreamableBindlessBuffer
+	{
+		std::vector<unsigned char> data; // uploaded again after eviction
+		unsigned long long lastUsedFrame; // kStreamableInUse until stamped by ProcessTouchedBindlessBuffers
+		std::list<int>::iterator lruPosition;
+	};
+
+	static const unsigned long long kStreamableInUse = ~0ull;
+
+	void CreateBindlessTable();
+
+	void DestroyBindlessTable();
+
+	void DestroyBindlessResource(BindlessResourceType type, int handle);
+
+	void ReleaseBindlessResource(BindlessResourceType type, int handle);
+
+	int AllocateBindlessBuffer(const void* data, int sizeInBytes, bool streamable);
+
+	// Creates the device buffer of a handle and points its descriptor at it, the caller holds m_BindlessMutex
+	bool UploadBindlessBuffer(int handle, const void* data, size_t sizeInBytes);
+
+	// Frees device memory of streamable buffers the GPU is done with, least recently used first, until bytes are freed.
+	// The caller holds m_BindlessMutex. Returns the bytes freed.
+	VkDeviceSize EvictStreamableBuffers(uint32_t heapIndex, VkDeviceSize bytes);
+
+	// Stamps buffers touched since the last call with the frame and uploads evicted ones again, the caller holds m_BindlessMutex
+	void ProcessTouchedBindlessBuffers(unsigned long long currentFrameNumber);
+
+	// Refreshes the driver budget, processes touches and evicts under pressure, once per frame from whichever render event runs first
+	void UpdateMemoryBudget(const UnityVulkanRecordingState& recordingState);
+
+	bool EnsureTrianglePipeline(VkRenderPass renderPass);
+
 	void CreateTraingleBuffer();
 
-	bool CreateVulkanBuffer(size_t sizeInBytes, VulkanBuffer* buffer, VkBufferUsageFlags usage);
+	// Host visible memory, with preferredMemoryFlags when such a type exists and has room.
+	// evictUnderPressure evicts streamable buffers when the heap is over budget or allocation fails, and requires m_BindlessMutex
+	bool CreateVulkanBuffer(size_t sizeInBytes, VulkanBuffer* buffer, VkBufferUsageFlags usage, bool evictUnderPressure = false, VkMemoryPropertyFlags preferredMemoryFlags = 0);
+
+	void WriteVulkanBuffer(const VulkanBuffer& buffer, const void* data, size_t sizeInBytes);
 
 	void ImmediateDestroyVulkanBuffer(const VulkanBuffer& buffer);
 
 	IUnityGraphicsVulkan* m_UnityVulkan;
 	UnityVulkanInstance m_Instance;
+	VulkanDispatchTable m_Vk;
 
 	VkPipelineLayout m_TrianglePipelineLayout;
 	VkPipeline m_TrianglePipeline;
 	VkRenderPass m_TrianglePipelineRenderPass;
 	VulkanBuffer m_VertexBuffer;
+
+	// Guards the bindless table, it is filled from the main thread and consumed on the render thread
+	std::mutex m_BindlessMutex;
+	VulkanBindlessTable m_BindlessTable;
+	VkSampler m_BindlessSampler;
+	// Evicted buffer slots point here, so shaders never read freed memory
+	VulkanBuffer m_BindlessFallbackBuffer;
+	std::unordered_map<int, VulkanBuffer> m_BindlessBuffers;
+	std::unordered_map<int, VkImageView> m_BindlessTextureViews;
+	std::vector<PendingBindlessTexture> m_PendingBindlessTextures;
+	std::vector<PendingBindlessRelease> m_PendingBindlessReleases;
+	// Evicted streamable buffers have no entry in m_BindlessBuffers. The LRU list starts at the least recently used handle.
+	std::unordered_map<int, StreamableBindlessBuffer> m_StreamableBuffers;
+	std::list<int> m_StreamableLru;
+	std::vector<int> m_TouchedBindlessBuffers;
+	unsigned long long m_SafeFrameNumber;
+
+	VulkanMemoryBudget m_MemoryBudget;
+	unsigned long long m_BudgetFrameNumber;
 };
@@ -2,6 +2,7 @@
 #include <format>
 #include "RenderingPlugin.h"
 #include "PlatformBase.h"
+#include "PluginCapture.h"
 
 IUnityInterfaces* RenderingPlugin::UnityInterfaces = nullptr;
 IUnityGraphics* RenderingPlugin::UnityGraphics = nullptr;
@@ -9,6 +10,9 @@ IUnityLog* RenderingPlugin::UnityLog = nullptr;
 UnityGfxRenderer RenderingPlugin::RHIType = kUnityGfxRendererNull;
 RenderAPI* RenderingPlugin::CurrentAPI = nullptr;
 float RenderingPlugin::Time;
+int RenderingPlugin::MaterialHandle = -1;
+float RenderingPlugin::EventTime;
+int RenderingPlugin::EventMaterialHandle = -1;
 
 static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType eventType);
 
@@ -21,12 +25,22 @@ extern "C" void	UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginLoad(IUnit
 	RenderingPlugin::UnityGraphics = RenderingPlugin::UnityInterfaces->Get<IUnityGraphics>();
 	RenderingPlugin::UnityGraphics->RegisterDeviceEventCallback(OnGraphicsDeviceEvent);
 
+#if SUPPORT_VULKAN
+	// Device creation can only be intercepted before Unity has created it
+	if (RenderingPlugin::UnityGraphics->GetRenderer() == kUnityGfxRendererNull)
+	{
+		extern void RenderAPI_Vulkan_OnPluginLoad(IUnityInterfaces*);
+		RenderAPI_Vulkan_OnPluginLoad(unityInterfaces);
+	}
+#endif // if SUPPORT_VULKAN
+
 	// Run OnGraphicsDeviceEvent(initialize) manually on plugin load
 	OnGraphicsDeviceEvent(kUnityGfxDeviceEventInitialize);
 }
 
 extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload()
 {
+	PluginCapture::End();
 	RenderingPlugin::UnityGraphics->UnregisterDeviceEventCallback(OnGraphicsDeviceEvent);
 	RenderingPlugin::UnityLog = nullptr;
 }
@@ -41,13 +55,124 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetTimeFromUnity(floa
 	RenderingPlugin::Time = t;
 	UNITY_LOG(RenderingPlugin::UnityLog, std::format("SetTimeFromUnity: {}", t).c_str());
 }
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetMaterialFromUnity(int handle)
+{
+	RenderingPlugin::MaterialHandle = handle;
+}
+
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API CreateBindlessBuffer(const void* data, int sizeInBytes)
+{
+	const int handle = RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->CreateBindlessBuffer(data, sizeInBytes) : -1;
+	if (handle >= 0)
+		PluginCapture::RecordBindlessBuffer(handle, data, static_cast<uint32_t>(sizeInBytes));
+	return handle;
+}
+
+// Replayed as a regular bindless buffer, eviction depends on the memory of the capturing machine
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API CreateStreamableBindlessBuffer(const void* data, int sizeInBytes)
+{
+	const int handle = RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->CreateStreamableBindlessBuffer(data, sizeInBytes) : -1;
+	if (handle >= 0)
+		PluginCapture::RecordBindlessBuffer(handle, data, static_cast<uint32_t>(sizeInBytes));
+	return handle;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API TouchBindlessBuffer(int handle)
+{
+	if (RenderingPlugin::CurrentAPI)
+		RenderingPlugin::CurrentAPI->TouchBindlessBuffer(handle);
+}
+
+// False for released handles and streamable buffers that are evicted and not uploaded again yet
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API IsBindlessBufferResident(int handle)
+{
+	return RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->IsBindlessBufferResident(handle) : false;
+}
+
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API RegisterBindlessTexture(void* nativeTexture)
+{
+	const int handle = RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->RegisterBindlessTexture(nativeTexture) : -1;
+	if (handle >= 0)
+		PluginCapture::RecordBindlessTexture(handle);
+	return handle;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ReleaseBindlessBuffer(int handle)
+{
+	PluginCapture::RecordBindlessRelease(kBindlessBuffer, handle);
+	if (RenderingPlugin::CurrentAPI)
+		RenderingPlugin::CurrentAPI->ReleaseBindlessBuffer(handle);
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ReleaseBindlessTexture(int handle)
+{
+	PluginCapture::RecordBindlessRelease(kBindlessTexture, handle);
+	if (RenderingPlugin::CurrentAPI)
+		RenderingPlugin::CurrentAPI->ReleaseBindlessTexture(handle);
+}
+
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetMemoryBudget(MemoryHeapBudget* heaps, int maxHeaps)
+{
+	return RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->GetMemoryBudget(heaps, maxHeaps) : 0;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetMemoryBudgetFraction(float fraction)
+{
+	if (RenderingPlugin::CurrentAPI)
+		RenderingPlugin::CurrentAPI->SetMemoryBudgetFraction(fraction);
+}
+
+// Record everything crossing the plugin boundary to a file until EndPluginCapture or kRenderEventEndCapture, see PluginCapture.h
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API BeginPluginCapture(const char* path)
+{
+	const bool success = PluginCapture::Begin(path);
+	UNITY_LOG(RenderingPlugin::UnityLog, std::format("BeginPluginCapture: {} {}", path, success ? "started" : "failed").c_str());
+	return success;
+}
+
+// Ends right away, render events the render thread has not run yet are lost. Issue kRenderEventEndCapture to keep them.
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API EndPluginCapture()
+{
+	PluginCapture::End();
+}
+
+// Software rasterizer framebuffer, used when there is no graphics device. See RenderAPI_Software.h
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetSoftwareFramebufferSize(int width, int height)
+{
+	return RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->ResizeSoftwareFramebuffer(width, height) : false;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ClearSoftwareFramebuffer(unsigned int rgba)
+{
+	if (RenderingPlugin::CurrentAPI)
+		RenderingPlugin::CurrentAPI->ClearSoftwareFramebuffer(rgba);
+}
+
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ReadSoftwareFramebuffer(void* pixels, int sizeInBytes)
+{
+	return RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->ReadSoftwareFramebuffer(pixels, sizeInBytes) : false;
+}
+
+extern "C" double UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetSoftwareFramebufferThroughput()
+{
+	return RenderingPlugin::CurrentAPI ? RenderingPlugin::CurrentAPI->GetSoftwareFramebufferThroughput() : 0.0;
+}
  
 static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType eventType)
 {
+	PluginCapture::RecordDeviceEvent(eventType);
+
 	// Create graphics API implementation upon initialization
 	if (eventType == kUnityGfxDeviceEventInitialize)
 	{
-		assert(RenderingPlugin::CurrentAPI == nullptr);
+		// Plugins loaded at startup get the manual initialize before Unity has a device, that software API is replaced here
+		if (RenderingPlugin::CurrentAPI)
+		{
+			RenderingPlugin::CurrentAPI->ProcessDeviceEvent(kUnityGfxDeviceEventShutdown, RenderingPlugin::UnityInterfaces);
+			delete RenderingPlugin::CurrentAPI;
+			RenderingPlugin::CurrentAPI = nullptr;
+		}
 		RenderingPlugin::RHIType = RenderingPlugin::UnityGraphics->GetRenderer();
 		RenderingPlugin::CurrentAPI = CreateRenderAPI(RenderingPlugin::RHIType);
 	}
@@ -69,12 +194,33 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
 
 static void UNITY_INTERFACE_API OnRenderEvent(int eventID)
 {
+	if (eventID == kRenderEventEndCapture)
+	{
+		PluginCapture::End();
+		return;
+	}
+
 	// Unknown / unsupported graphics device type? Do nothing
 	if (RenderingPlugin::CurrentAPI == NULL)
 		return;
 
-	if (eventID == 1)
+	// Read once, the main thread may change them while the event runs
+	RenderingPlugin::EventTime = RenderingPlugin::Time;
+	RenderingPlugin::EventMaterialHandle = RenderingPlugin::MaterialHandle;
+
+	if (eventID == kRenderEventDrawColoredTriangle)
 	{
 		RenderingPlugin::CurrentAPI->DrawColoredTriangle();
 	}
+	else if (eventID == kRenderEventBenchmarkCommandRecording)
+	{
+		RenderingPlugin::CurrentAPI->BenchmarkCommandRecording();
+	}
+	else if (eventID == kRenderEventUpdateBindlessTable)
+	{
+		RenderingPlugin::CurrentAPI->UpdateBindlessTable();
+	}
+
+	// Written after the implementation captured the recording state the event ran with
+	PluginCapture::RecordRenderEvent(eventID, RenderingPlugin::EventTime, RenderingPlugin::EventMaterialHandle);
 }
\ No newline at end of file
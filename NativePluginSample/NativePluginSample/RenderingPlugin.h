@@ -5,6 +5,16 @@
 #include <IUnityLog.h>
 #include "RenderAPI.h"
 
+// Event IDs issued from C# through CommandBuffer.IssuePluginEvent
+enum RenderEventID
+{
+	kRenderEventDrawColoredTriangle = 1,
+	kRenderEventBenchmarkCommandRecording = 2,
+	kRenderEventUpdateBindlessTable = 3,
+	// Ends a capture on the render thread, after every event issued before it was recorded. Not captured itself.
+	kRenderEventEndCapture = 4,
+};
+
 class RenderingPlugin
 {
 public:
@@ -16,4 +26,8 @@ public:
 	static UnityGfxRenderer RHIType;
 	static RenderAPI* CurrentAPI;
 	static float Time;
+	static int MaterialHandle;
+	// Time and MaterialHandle as read when the current render event started, implementations draw with these
+	static float EventTime;
+	static int EventMaterialHandle;
 };
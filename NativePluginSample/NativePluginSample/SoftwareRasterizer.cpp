@@ -0,0 +1,383 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+// Vertex positions are snapped to 1/256 pixel, so the edge coefficients computed in double are exact. The per-pixel float
+// evaluation rounds symmetrically, so shared edges still come out bit-identical (with opposite signs) in both triangles,
+// which together with the top-left rule makes meshes watertight
+static double SnapToSubpixel(double value)
+{
+	return std::round(value * 256.0) / 256.0;
+}
+
+SoftwareRasterizer::SoftwareRasterizer()
+	:m_Width(0), m_Height(0), m_Stride(0), m_TilesX(0), m_TilesY(0), m_ClearPending(false), m_ClearColor(0), m_ClearDepth(0.0f)
+	, m_ThreadCount(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+	, m_WorkGeneration(0), m_WorkersBusy(0), m_Quit(false), m_NextTile(0), m_StatPixels(0), m_StatNanoseconds(0)
+{
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_WorkMutex);
+		m_Quit = true;
+	}
+	m_WorkStart.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+bool SoftwareRasterizer::Resize(int width, int height)
+{
+	if (width <= 0 || height <= 0 || width > 16384 || height > 16384)
+		return false;
+
+	m_Width = width;
+	m_Height = height;
+	m_Stride = (width + 3) & ~3;
+	m_TilesX = (width + kTileSize - 1) / kTileSize;
+	m_TilesY = (height + kTileSize - 1) / kTileSize;
+	m_Color.assign(static_cast<size_t>(m_Stride) * height, 0);
+	m_Depth.assign(static_cast<size_t>(m_Stride) * height, 0.0f);
+
+	m_Triangles.clear();
+	m_TileBins.clear();
+	m_TileBins.resize(static_cast<size_t>(m_TilesX) * m_TilesY);
+	m_ClearPending = false;
+	return true;
+}
+
+void SoftwareRasterizer::Clear(uint32_t color, float depth)
+{
+	// Every pixel is overwritten, triangles binned so far would never be visible
+	m_Triangles.clear();
+	for (std::vector<uint32_t>& bin : m_TileBins)
+		bin.clear();
+
+	m_ClearPending = true;
+	m_ClearColor = color;
+	m_ClearDepth = depth;
+}
+
+void SoftwareRasterizer::DrawTriangles(const SoftwareVertex* vertices, int vertexCount)
+{
+	if (m_Width == 0)
+		return;
+
+	// Setup and binning count towards the stats too, auto flushes time themselves
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i + 2 < vertexCount; i += 3)
+	{
+		const SoftwareVertex* v[3] = { &vertices[i], &vertices[i + 1], &vertices[i + 2] };
+		if (v[0]->w <= 0.0f || v[1]->w <= 0.0f || v[2]->w <= 0.0f)
+			continue;
+
+		// Viewport transform, NDC y = -1 is the top row like Vulkan
+		double x[3], y[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			const double invW = 1.0 / v[k]->w;
+			x[k] = SnapToSubpixel((v[k]->x * invW * 0.5 + 0.5) * m_Width);
+			y[k] = SnapToSubpixel((v[k]->y * invW * 0.5 + 0.5) * m_Height);
+		}
+
+		double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+		if (area == 0.0 || !std::isfinite(area))
+			continue;
+
+		// No culling, wind every triangle the same way so inside is always E > 0
+		if (area < 0.0)
+		{
+			std::swap(v[1], v[2]);
+			std::swap(x[1], x[2]);
+			std::swap(y[1], y[2]);
+			area = -area;
+		}
+
+		const double boundsMinX = std::floor(std::min({ x[0], x[1], x[2] }));
+		const double boundsMinY = std::floor(std::min({ y[0], y[1], y[2] }));
+		const double boundsMaxX = std::ceil(std::max({ x[0], x[1], x[2] }));
+		const double boundsMaxY = std::ceil(std::max({ y[0], y[1], y[2] }));
+		if (boundsMaxX < 0.0 || boundsMaxY < 0.0 || boundsMinX >= m_Width || boundsMinY >= m_Height)
+			continue;
+
+		Triangle triangle;
+		triangle.minX = static_cast<int>(std::max(boundsMinX, 0.0));
+		triangle.minY = static_cast<int>(std::max(boundsMinY, 0.0));
+		triangle.maxX = static_cast<int>(std::min(boundsMaxX, m_Width - 1.0));
+		triangle.maxY = static_cast<int>(std::min(boundsMaxY, m_Height - 1.0));
+
+		// Edge k is opposite vertex k
+		for (int k = 0; k < 3; ++k)
+		{
+			const int a = (k + 1) % 3;
+			const int b = (k + 2) % 3;
+			triangle.edgeA[k] = y[a] - y[b];
+			triangle.edgeB[k] = x[b] - x[a];
+			triangle.edgeC[k] = x[a] * y[b] - y[a] * x[b];
+			// Pixel centers exactly on an edge belong to top and left edges only
+			triangle.edgeTopLeft[k] = triangle.edgeA[k] > 0.0 || (triangle.edgeA[k] == 0.0 && triangle.edgeB[k] > 0.0);
+		}
+		triangle.invArea = 1.0 / area;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			const float invW = 1.0f / v[k]->w;
+			triangle.z[k] = v[k]->z * invW;
+			triangle.invW[k] = invW;
+			triangle.colorOverW[k][0] = v[k]->r * invW;
+			triangle.colorOverW[k][1] = v[k]->g * invW;
+			triangle.colorOverW[k][2] = v[k]->b * invW;
+			triangle.colorOverW[k][3] = v[k]->a * invW;
+		}
+
+		const uint32_t triangleIndex = static_cast<uint32_t>(m_Triangles.size());
+		m_Triangles.push_back(triangle);
+		for (int tileY = triangle.minY / kTileSize; tileY <= triangle.maxY / kTileSize; ++tileY)
+		{
+			for (int tileX = triangle.minX / kTileSize; tileX <= triangle.maxX / kTileSize; ++tileX)
+				m_TileBins[tileY * m_TilesX + tileX].push_back(triangleIndex);
+		}
+
+		if (m_Triangles.size() >= kMaxBinnedTriangles)
+		{
+			m_StatNanoseconds += static_cast<uint64_t>(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+			Flush();
+			start = std::chrono::steady_clock::now();
+		}
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	m_StatNanoseconds += static_cast<uint64_t>(elapsed.count());
+}
+
+void SoftwareRasterizer::Flush()
+{
+	if (!m_ClearPending && m_Triangles.empty())
+		return;
+
+	// Started on first use so a plugin that never rasterizes doesn't keep idle threads around
+	if (m_Workers.empty())
+	{
+		for (int i = 1; i < m_ThreadCount; ++i)
+			m_Workers.emplace_back(&SoftwareRasterizer::WorkerMain, this);
+	}
+
+	m_NextTile = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_WorkMutex);
+		m_WorkersBusy = static_cast<int>(m_Workers.size());
+		++m_WorkGeneration;
+	}
+	m_WorkStart.notify_all();
+
+	RasterizeTiles();
+
+	// Workers must be done with this flush before the bins are reused
+	{
+		std::unique_lock<std::mutex> lock(m_WorkMutex);
+		m_WorkDone.wait(lock, [this] { return m_WorkersBusy == 0; });
+	}
+
+	m_Triangles.clear();
+	for (std::vector<uint32_t>& bin : m_TileBins)
+		bin.clear();
+	m_ClearPending = false;
+}
+
+void SoftwareRasterizer::ReadColor(void* pixels)
+{
+	Flush();
+
+	const size_t rowSize = static_cast<size_t>(m_Width) * sizeof(uint32_t);
+	for (int y = 0; y < m_Height; ++y)
+		memcpy(static_cast<uint8_t*>(pixels) + rowSize * y, &m_Color[static_cast<size_t>(m_Stride) * y], rowSize);
+}
+
+void SoftwareRasterizer::TakeStats(uint64_t* pixels, double* seconds)
+{
+	*pixels = m_StatPixels.exchange(0);
+	*seconds = m_StatNanoseconds.exchange(0) * 1e-9;
+}
+
+void SoftwareRasterizer::WorkerMain()
+{
+	uint64_t generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_WorkMutex);
+			m_WorkStart.wait(lock, [&] { return m_Quit || m_WorkGeneration != generation; });
+			if (m_Quit)
+				return;
+			generation = m_WorkGeneration;
+		}
+
+		RasterizeTiles();
+
+		{
+			std::lock_guard<std::mutex> lock(m_WorkMutex);
+			if (--m_WorkersBusy == 0)
+				m_WorkDone.notify_one();
+		}
+	}
+}
+
+void SoftwareRasterizer::RasterizeTiles()
+{
+	const int tileCount = m_TilesX * m_TilesY;
+	const auto start = std::chrono::steady_clock::now();
+	uint64_t coveredPixels = 0;
+	bool worked = false;
+
+	for (int tileIndex = m_NextTile++; tileIndex < tileCount; tileIndex = m_NextTile++)
+	{
+		if (!m_ClearPending && m_TileBins[tileIndex].empty())
+			continue;
+
+		const int tileX0 = (tileIndex % m_TilesX) * kTileSize;
+		const int tileY0 = (tileIndex / m_TilesX) * kTileSize;
+		const int tileX1 = std::min(tileX0 + kTileSize, m_Width);
+		const int tileY1 = std::min(tileY0 + kTileSize, m_Height);
+
+		if (m_ClearPending)
+		{
+			for (int y = tileY0; y < tileY1; ++y)
+			{
+				const size_t row = static_cast<size_t>(m_Stride) * y;
+				std::fill(m_Color.data() + row + tileX0, m_Color.data() + row + tileX1, m_ClearColor);
+				std::fill(m_Depth.data() + row + tileX0, m_Depth.data() + row + tileX1, m_ClearDepth);
+			}
+		}
+
+		for (uint32_t triangleIndex : m_TileBins[tileIndex])
+			RasterizeTriangle(m_Triangles[triangleIndex], tileX0, tileY0, tileX1, tileY1, &coveredPixels);
+		worked = true;
+	}
+
+	if (!worked)
+		return;
+
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	m_StatPixels += coveredPixels;
+	m_StatNanoseconds += static_cast<uint64_t>(elapsed.count());
+}
+
+void SoftwareRasterizer::RasterizeTriangle(const Triangle& triangle, int tileX0, int tileY0, int tileX1, int tileY1, uint64_t* coveredPixels)
+{
+	// Tiles start on multiples of 4 and rows are padded to 4, so aligned groups of 4 pixels never touch another tile
+	const int x0 = std::max(triangle.minX, tileX0) & ~3;
+	const int x1 = std::min(triangle.maxX + 1, tileX1);
+	const int y0 = std::max(triangle.minY, tileY0);
+	const int y1 = std::min(triangle.maxY + 1, tileY1);
+	if (x0 >= x1 || y0 >= y1)
+		return;
+
+	// Edges are evaluated relative to the tile origin, identical for every triangle in the tile
+	const double originX = tileX0 + 0.5;
+	const double originY = tileY0 + 0.5;
+	float edgeOrigin[3], edgeA[3], edgeB[3];
+	__m128 edgeTopLeft[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		edgeOrigin[k] = static_cast<float>(triangle.edgeA[k] * originX + triangle.edgeB[k] * originY + triangle.edgeC[k]);
+		edgeA[k] = static_cast<float>(triangle.edgeA[k]);
+		edgeB[k] = static_cast<float>(triangle.edgeB[k]);
+		edgeTopLeft[k] = _mm_castsi128_ps(_mm_set1_epi32(triangle.edgeTopLeft[k] ? -1 : 0));
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 invArea = _mm_set1_ps(static_cast<float>(triangle.invArea));
+	const __m128 columnEnd = _mm_set1_ps(static_cast<float>(x1 - tileX0));
+	const __m128 edgeStepX[3] = { _mm_set1_ps(edgeA[0]), _mm_set1_ps(edgeA[1]), _mm_set1_ps(edgeA[2]) };
+
+	for (int y = y0; y < y1; ++y)
+	{
+		const float dy = static_cast<float>(y - tileY0);
+		float edgeRowValue[3];
+		for (int k = 0; k < 3; ++k)
+			edgeRowValue[k] = edgeOrigin[k] + edgeB[k] * dy;
+
+		// Conservative span of the row where every edge can be positive, the exact test still runs per pixel
+		float spanStart = static_cast<float>(x0 - tileX0);
+		float spanEnd = static_cast<float>(x1 - tileX0);
+		for (int k = 0; k < 3; ++k)
+		{
+			if (edgeA[k] > 0.0f)
+				spanStart = std::max(spanStart, -edgeRowValue[k] / edgeA[k] - 1.0f);
+			else if (edgeA[k] < 0.0f)
+				spanEnd = std::min(spanEnd, -edgeRowValue[k] / edgeA[k] + 1.0f);
+			else if (edgeRowValue[k] < 0.0f)
+				spanEnd = -1.0f;
+		}
+		if (spanStart >= spanEnd)
+			continue;
+		const __m128 edgeRow[3] = { _mm_set1_ps(edgeRowValue[0]), _mm_set1_ps(edgeRowValue[1]), _mm_set1_ps(edgeRowValue[2]) };
+		const int rowX0 = std::max(x0, (tileX0 + static_cast<int>(spanStart)) & ~3);
+		const int rowX1 = std::min(x1, tileX0 + static_cast<int>(std::ceil(spanEnd)));
+
+		uint32_t* colorRow = &m_Color[static_cast<size_t>(m_Stride) * y];
+		float* depthRow = &m_Depth[static_cast<size_t>(m_Stride) * y];
+
+		for (int x = rowX0; x < rowX1; x += 4)
+		{
+			const __m128 dx = _mm_add_ps(_mm_set1_ps(static_cast<float>(x - tileX0)), laneOffsets);
+
+			__m128 edge[3];
+			__m128 mask = _mm_cmplt_ps(dx, columnEnd);
+			for (int k = 0; k < 3; ++k)
+			{
+				edge[k] = _mm_add_ps(edgeRow[k], _mm_mul_ps(edgeStepX[k], dx));
+				const __m128 inside = _mm_or_ps(_mm_cmpgt_ps(edge[k], zero), _mm_and_ps(_mm_cmpeq_ps(edge[k], zero), edgeTopLeft[k]));
+				mask = _mm_and_ps(mask, inside);
+			}
+
+			int laneMask = _mm_movemask_ps(mask);
+			if (laneMask == 0)
+				continue;
+			*coveredPixels += std::popcount(static_cast<unsigned int>(laneMask));
+
+			const __m128 l0 = _mm_mul_ps(edge[0], invArea);
+			const __m128 l1 = _mm_mul_ps(edge[1], invArea);
+			const __m128 l2 = _mm_mul_ps(edge[2], invArea);
+
+			// Screen-space depth is linear, clipped to [0, 1] like the Vulkan depth range
+			const __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, _mm_set1_ps(triangle.z[0])), _mm_mul_ps(l1, _mm_set1_ps(triangle.z[1]))), _mm_mul_ps(l2, _mm_set1_ps(triangle.z[2])));
+			const __m128 oldDepth = _mm_loadu_ps(depthRow + x);
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(z, oldDepth));
+			mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(z, zero), _mm_cmple_ps(z, one)));
+			laneMask = _mm_movemask_ps(mask);
+			if (laneMask == 0)
+				continue;
+
+			_mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, oldDepth)));
+
+			// Perspective-correct color: interpolate color / w and 1 / w, then divide. colorOverW already holds the first.
+			const __m128 q0 = _mm_mul_ps(l0, _mm_set1_ps(triangle.invW[0]));
+			const __m128 q1 = _mm_mul_ps(l1, _mm_set1_ps(triangle.invW[1]));
+			const __m128 q2 = _mm_mul_ps(l2, _mm_set1_ps(triangle.invW[2]));
+			const __m128 w = _mm_div_ps(scale, _mm_add_ps(_mm_add_ps(q0, q1), q2));
+
+			__m128i packed = _mm_setzero_si128();
+			for (int c = 0; c < 4; ++c)
+			{
+				__m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, _mm_set1_ps(triangle.colorOverW[0][c])), _mm_mul_ps(l1, _mm_set1_ps(triangle.colorOverW[1][c]))),
+					_mm_mul_ps(l2, _mm_set1_ps(triangle.colorOverW[2][c])));
+				value = _mm_min_ps(_mm_max_ps(_mm_mul_ps(value, w), zero), scale);
+				packed = _mm_or_si128(packed, _mm_sll_epi32(_mm_cvtps_epi32(value), _mm_cvtsi32_si128(c * 8)));
+			}
+
+			const __m128i colorMask = _mm_castps_si128(mask);
+			__m128i* colorAddress = reinterpret_cast<__m128i*>(colorRow + x);
+			const __m128i oldColor = _mm_loadu_si128(colorAddress);
+			_mm_storeu_si128(colorAddress, _mm_or_si128(_mm_and_si128(colorMask, packed), _mm_andnot_si128(colorMask, oldColor)));
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Vertex after the vertex shader: clip space position and a color interpolated with perspective correction
+struct SoftwareVertex
+{
+	float x, y, z, w;
+	float r, g, b, a;
+};
+
+// Tile-binned triangle rasterizer writing RGBA8 color and float depth.
+// Draws only set up and bin triangles, Flush() rasterizes the bins on a pool of worker threads, one tile at a time,
+// so every pixel is owned by a single thread and triangles keep their submission order within a tile.
+// Pixels are processed 4 at a time with SSE2. Depth test is GREATER_OR_EQUAL with writes, matching reverse-Z pipelines.
+// Not thread-safe, callers serialize access.
+class SoftwareRasterizer
+{
+public:
+	static const int kTileSize = 64;
+	// Binned triangles are flushed automatically past this count to bound memory
+	static const size_t kMaxBinnedTriangles = 1 << 16;
+
+	SoftwareRasterizer();
+	~SoftwareRasterizer();
+
+	// Drops binned triangles and zeroes color and depth
+	bool Resize(int width, int height);
+
+	int GetWidth() const { return m_Width; }
+
+	int GetHeight() const { return m_Height; }
+
+	// Applied to every pixel before the triangles binned after it, triangles binned before it are dropped
+	void Clear(uint32_t color, float depth);
+
+	// Triangle list in clip space. Triangles with a vertex behind the eye (w <= 0) are dropped, there is no near plane clipping.
+	void DrawTriangles(const SoftwareVertex* vertices, int vertexCount);
+
+	// Rasterizes everything binned so far, blocks until done
+	void Flush();
+
+	// Copies the color buffer into tightly packed rows, flushes first
+	void ReadColor(void* pixels);
+
+	// Pixels covered by triangles and the thread time spent setting up, binning and rasterizing them since the last call
+	void TakeStats(uint64_t* pixels, double* seconds);
+
+	// Includes the calling thread, workers are started by the first Flush()
+	int GetThreadCount() const { return m_ThreadCount; }
+
+private:
+	struct Triangle
+	{
+		// Edge functions E = A * x + B * y + C, positive inside, in pixel units
+		double edgeA[3], edgeB[3], edgeC[3];
+		bool edgeTopLeft[3];
+		double invArea;
+		float z[3];
+		float invW[3];
+		float colorOverW[3][4];
+		int minX, minY, maxX, maxY;
+	};
+
+	void WorkerMain();
+
+	void RasterizeTiles();
+
+	void RasterizeTriangle(const Triangle& triangle, int tileX0, int tileY0, int tileX1, int tileY1, uint64_t* coveredPixels);
+
+	int m_Width;
+	int m_Height;
+	int m_Stride; // in pixels, multiple of 4 so SSE groups never cross the end of a row
+	int m_TilesX;
+	int m_TilesY;
+	std::vector<uint32_t> m_Color;
+	std::vector<float> m_Depth;
+
+	std::vector<Triangle> m_Triangles;
+	std::vector<std::vector<uint32_t>> m_TileBins;
+	bool m_ClearPending;
+	uint32_t m_ClearColor;
+	float m_ClearDepth;
+
+	// Worker pool, woken once per Flush; the calling thread rasterizes tiles as well
+	int m_ThreadCount;
+	std::vector<std::thread> m_Workers;
+	std::mutex m_WorkMutex;
+	std::condition_variable m_WorkStart;
+	std::condition_variable m_WorkDone;
+	uint64_t m_WorkGeneration;
+	int m_WorkersBusy;
+	bool m_Quit;
+	std::atomic<int> m_NextTile;
+
+	std::atomic<uint64_t> m_StatPixels;
+	std::atomic<uint64_t> m_StatNanoseconds;
+};
@@ -0,0 +1,195 @@
+#include "VulkanBindlessTable.h"
+
+#include <algorithm>
+
+VulkanBindlessTable::VulkanBindlessTable()
+	:m_DescriptorSetLayout(VK_NULL_HANDLE), m_DescriptorPool(VK_NULL_HANDLE), m_DescriptorSet(VK_NULL_HANDLE), m_Capacity{}, m_NextHandle{}
+{
+}
+
+// Combined image samplers count as both a sampler and a sampled image, every stage of ALL_GRAPHICS sees both arrays
+static bool QueryCapacity(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice, uint32_t capacity[kBindlessResourceTypeCount])
+{
+	if (!vk.vkGetPhysicalDeviceProperties2)
+		return false;
+
+	VkPhysicalDeviceDescriptorIndexingProperties limits = {};
+	limits.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+	VkPhysicalDeviceProperties2 properties = {};
+	properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties.pNext = &limits;
+	vk.vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+	uint32_t textures = std::min({ VulkanBindlessTable::kMaxTextures,
+		limits.maxPerStageDescriptorUpdateAfterBindSamplers, limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		limits.maxDescriptorSetUpdateAfterBindSamplers, limits.maxDescriptorSetUpdateAfterBindSampledImages });
+	uint32_t buffers = std::min({ VulkanBindlessTable::kMaxBuffers,
+		limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers, limits.maxDescriptorSetUpdateAfterBindStorageBuffers });
+
+	// Both arrays share the per-stage resource and pool limits, split them evenly when they do not fit together
+	const uint32_t totalLimit = std::min(limits.maxPerStageUpdateAfterBindResources, limits.maxUpdateAfterBindDescriptorsInAllPools);
+	if (textures + buffers > totalLimit)
+	{
+		textures = std::min(textures, totalLimit / 2);
+		buffers = std::min(buffers, totalLimit - textures);
+	}
+
+	capacity[kBindlessTexture] = textures;
+	capacity[kBindlessBuffer] = buffers;
+	return textures > 0 && buffers > 0;
+}
+
+bool VulkanBindlessTable::Create(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice, VkDevice device)
+{
+	if (!QueryCapacity(vk, physicalDevice, m_Capacity))
+		return false;
+
+	// Slots may be empty, and may be rewritten while the set is bound as long as in-flight work does not use them
+	const VkDescriptorBindingFlags bindingFlags[kBindlessResourceTypeCount] = {
+		VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT,
+		VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT,
+	};
+
+	VkDescriptorSetLayoutBinding bindings[kBindlessResourceTypeCount] = {};
+	bindings[kBindlessTexture].binding = kBindlessTexture;
+	bindings[kBindlessTexture].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	bindings[kBindlessTexture].descriptorCount = m_Capacity[kBindlessTexture];
+	bindings[kBindlessTexture].stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+	bindings[kBindlessBuffer].binding = kBindlessBuffer;
+	bindings[kBindlessBuffer].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[kBindlessBuffer].descriptorCount = m_Capacity[kBindlessBuffer];
+	bindings[kBindlessBuffer].stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo = {};
+	bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	bindingFlagsCreateInfo.bindingCount = kBindlessResourceTypeCount;
+	bindingFlagsCreateInfo.pBindingFlags = bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo layoutCreateInfo = {};
+	layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+	layoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	layoutCreateInfo.bindingCount = kBindlessResourceTypeCount;
+	layoutCreateInfo.pBindings = bindings;
+
+	if (vk.vkCreateDescriptorSetLayout(device, &layoutCreateInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
+	{
+		m_DescriptorSetLayout = VK_NULL_HANDLE;
+		return false;
+	}
+
+	VkDescriptorPoolSize poolSizes[kBindlessResourceTypeCount];
+	poolSizes[kBindlessTexture].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSizes[kBindlessTexture].descriptorCount = m_Capacity[kBindlessTexture];
+	poolSizes[kBindlessBuffer].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	poolSizes[kBindlessBuffer].descriptorCount = m_Capacity[kBindlessBuffer];
+
+	VkDescriptorPoolCreateInfo poolCreateInfo = {};
+	poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+	poolCreateInfo.maxSets = 1;
+	poolCreateInfo.poolSizeCount = kBindlessResourceTypeCount;
+	poolCreateInfo.pPoolSizes = poolSizes;
+
+	if (vk.vkCreateDescriptorPool(device, &poolCreateInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS)
+	{
+		m_DescriptorPool = VK_NULL_HANDLE;
+		Destroy(vk, device);
+		return false;
+	}
+
+	VkDescriptorSetAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocateInfo.descriptorPool = m_DescriptorPool;
+	allocateInfo.descriptorSetCount = 1;
+	allocateInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+	if (vk.vkAllocateDescriptorSets(device, &allocateInfo, &m_DescriptorSet) != VK_SUCCESS)
+	{
+		m_DescriptorSet = VK_NULL_HANDLE;
+		Destroy(vk, device);
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanBindlessTable::Destroy(const VulkanDispatchTable& vk, VkDevice device)
+{
+	// Destroying the pool frees the set
+	if (m_DescriptorPool != VK_NULL_HANDLE)
+		vk.vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
+	if (m_DescriptorSetLayout != VK_NULL_HANDLE)
+		vk.vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+
+	*this = VulkanBindlessTable();
+}
+
+int VulkanBindlessTable::AllocateHandle(BindlessResourceType type)
+{
+	std::vector<int>& freeHandles = m_FreeHandles[type];
+	if (!freeHandles.empty())
+	{
+		const int handle = freeHandles.back();
+		freeHandles.pop_back();
+		m_Allocated[type][handle] = true;
+		return handle;
+	}
+
+	if (m_NextHandle[type] >= static_cast<int>(m_Capacity[type]))
+		return -1;
+
+	m_Allocated[type].push_back(true);
+	return m_NextHandle[type]++;
+}
+
+bool VulkanBindlessTable::IsAllocated(BindlessResourceType type, int handle) const
+{
+	return handle >= 0 && handle < m_NextHandle[type] && m_Allocated[type][handle];
+}
+
+void VulkanBindlessTable::ReleaseHandle(BindlessResourceType type, int handle)
+{
+	// A slot on the free list twice would be handed out to two resources
+	if (!IsAllocated(type, handle))
+		return;
+
+	m_Allocated[type][handle] = false;
+	m_FreeHandles[type].push_back(handle);
+}
+
+void VulkanBindlessTable::WriteTexture(const VulkanDispatchTable& vk, VkDevice device, int handle, VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout)
+{
+	VkDescriptorImageInfo imageInfo;
+	imageInfo.sampler = sampler;
+	imageInfo.imageView = imageView;
+	imageInfo.imageLayout = imageLayout;
+
+	VkWriteDescriptorSet write = {};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = m_DescriptorSet;
+	write.dstBinding = kBindlessTexture;
+	write.dstArrayElement = static_cast<uint32_t>(handle);
+	write.descriptorCount = 1;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	write.pImageInfo = &imageInfo;
+	vk.vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+void VulkanBindlessTable::WriteBuffer(const VulkanDispatchTable& vk, VkDevice device, int handle, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+	VkDescriptorBufferInfo bufferInfo;
+	bufferInfo.buffer = buffer;
+	bufferInfo.offset = offset;
+	bufferInfo.range = range;
+
+	VkWriteDescriptorSet write = {};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = m_DescriptorSet;
+	write.dstBinding = kBindlessBuffer;
+	write.dstArrayElement = static_cast<uint32_t>(handle);
+	write.descriptorCount = 1;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	write.pBufferInfo = &bufferInfo;
+	vk.vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
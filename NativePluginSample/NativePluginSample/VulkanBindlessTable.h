@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include "RenderAPI.h"
+#include "VulkanDispatchTable.h"
+
+// One large update-after-bind descriptor set holding every texture and storage buffer the plugin uses.
+// Each BindlessResourceType is the binding index of its array.
+// Shaders index the arrays with integer handles, so switching resources between draws needs no descriptor set updates.
+// Unity binds its own sets between plugin events, so every event that draws binds the set again:
+//   layout(set = 0, binding = 0) uniform sampler2D textures[];
+//   layout(set = 0, binding = 1) buffer Buffers { uint data[]; } buffers[];
+// Not thread-safe, callers serialize access.
+class VulkanBindlessTable
+{
+public:
+	// Upper bounds, the arrays are clamped to the update-after-bind limits of the device
+	static const uint32_t kMaxTextures = 4096;
+	static const uint32_t kMaxBuffers = 4096;
+
+	VulkanBindlessTable();
+
+	bool Create(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice, VkDevice device);
+
+	void Destroy(const VulkanDispatchTable& vk, VkDevice device);
+
+	bool IsValid() const { return m_DescriptorSet != VK_NULL_HANDLE; }
+
+	uint32_t GetCapacity(BindlessResourceType type) const { return m_Capacity[type]; }
+
+	VkDescriptorSetLayout GetLayout() const { return m_DescriptorSetLayout; }
+
+	VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+
+	// Returns a free slot of the given array, or -1 when it is full. Handles stay valid until released.
+	int AllocateHandle(BindlessResourceType type);
+
+	// Handles come from scripts, anything not returned by AllocateHandle or already released is rejected
+	bool IsAllocated(BindlessResourceType type, int handle) const;
+
+	// The slot must no longer be referenced by in-flight command buffers. Releasing a free slot does nothing.
+	void ReleaseHandle(BindlessResourceType type, int handle);
+
+	void WriteTexture(const VulkanDispatchTable& vk, VkDevice device, int handle, VkImageView imageView, VkSampler sampler, VkImageLayout imageLayout);
+
+	void WriteBuffer(const VulkanDispatchTable& vk, VkDevice device, int handle, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
+private:
+	VkDescriptorSetLayout m_DescriptorSetLayout;
+	VkDescriptorPool m_DescriptorPool;
+	VkDescriptorSet m_DescriptorSet;
+
+	uint32_t m_Capacity[kBindlessResourceTypeCount];
+	int m_NextHandle[kBindlessResourceTypeCount];
+	std::vector<int> m_FreeHandles[kBindlessResourceTypeCount];
+	std::vector<bool> m_Allocated[kBindlessResourceTypeCount];
+};
@@ -0,0 +1,67 @@
+#include "VulkanDispatchTable.h"
+#include <cstring>
+#include <vector>
+
+bool HasVulkanDeviceExtension(PFN_vkEnumerateDeviceExtensionProperties enumerateDeviceExtensionProperties, VkPhysicalDevice physicalDevice, const char* extensionName)
+{
+	uint32_t extensionCount = 0;
+	if (enumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr) != VK_SUCCESS)
+		return false;
+
+	std::vector<VkExtensionProperties> extensions(extensionCount);
+	if (enumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data()) != VK_SUCCESS)
+		return false;
+
+	for (const VkExtensionProperties& extension : extensions)
+	{
+		if (strcmp(extension.extensionName, extensionName) == 0)
+			return true;
+	}
+	return false;
+}
+
+bool VulkanDispatchTable::Load(const UnityVulkanInstance& instance, const char* drawIndirectCountFunction)
+{
+	*this = VulkanDispatchTable();
+
+	vkGetInstanceProcAddr = instance.getInstanceProcAddr;
+	if (!vkGetInstanceProcAddr || instance.instance == VK_NULL_HANDLE || instance.device == VK_NULL_HANDLE)
+		return false;
+
+	bool success = true;
+
+#define LOAD_VULKAN_INSTANCE_FUNC(fn) fn = (PFN_##fn)vkGetInstanceProcAddr(instance.instance, #fn); success = success && fn != nullptr
+	VULKAN_INSTANCE_API_FUNCTIONS(LOAD_VULKAN_INSTANCE_FUNC);
+#undef LOAD_VULKAN_INSTANCE_FUNC
+
+	if (!vkGetDeviceProcAddr)
+		return false;
+
+#define LOAD_VULKAN_DEVICE_FUNC(fn) fn = (PFN_##fn)vkGetDeviceProcAddr(instance.device, #fn); success = success && fn != nullptr
+	VULKAN_DEVICE_API_FUNCTIONS(LOAD_VULKAN_DEVICE_FUNC);
+#undef LOAD_VULKAN_DEVICE_FUNC
+
+	// A non-null vkGetDeviceProcAddr result does not prove the command is usable: the core entry point exists on every
+	// 1.2 device even without the drawIndirectCount feature, and some drivers return commands of extensions that are not enabled
+	if (drawIndirectCountFunction)
+		vkCmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCount)vkGetDeviceProcAddr(instance.device, drawIndirectCountFunction);
+	supportsDrawIndirectCount = vkCmdDrawIndexedIndirectCount != nullptr;
+
+	vkCreateRenderPass2 = (PFN_vkCreateRenderPass2)vkGetDeviceProcAddr(instance.device, "vkCreateRenderPass2");
+	if (!vkCreateRenderPass2)
+		vkCreateRenderPass2 = (PFN_vkCreateRenderPass2)vkGetDeviceProcAddr(instance.device, "vkCreateRenderPass2KHR");
+
+	vkGetPhysicalDeviceProperties2 = (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(instance.instance, "vkGetPhysicalDeviceProperties2");
+	if (!vkGetPhysicalDeviceProperties2)
+		vkGetPhysicalDeviceProperties2 = (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(instance.instance, "vkGetPhysicalDeviceProperties2KHR");
+
+	// VK_EXT_memory_budget only extends a physical device query, it is usable as soon as the physical device supports it
+	vkGetPhysicalDeviceMemoryProperties2 = (PFN_vkGetPhysicalDeviceMemoryProperties2)vkGetInstanceProcAddr(instance.instance, "vkGetPhysicalDeviceMemoryProperties2");
+	if (!vkGetPhysicalDeviceMemoryProperties2)
+		vkGetPhysicalDeviceMemoryProperties2 = (PFN_vkGetPhysicalDeviceMemoryProperties2)vkGetInstanceProcAddr(instance.instance, "vkGetPhysicalDeviceMemoryProperties2KHR");
+	supportsMemoryBudget = vkGetPhysicalDeviceMemoryProperties2 != nullptr
+		&& vkEnumerateDeviceExtensionProperties != nullptr
+		&& HasVulkanDeviceExtension(vkEnumerateDeviceExtensionProperties, instance.physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+	return success;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+// This plugin does not link to the Vulkan loader, easier to support multiple APIs and systems that don't have Vulkan support
+#define VK_NO_PROTOTYPES
+#include <IUnityGraphicsVulkan.h>
+
+// Functions that dispatch on VkInstance/VkPhysicalDevice, resolved through vkGetInstanceProcAddr
+#define VULKAN_INSTANCE_API_FUNCTIONS(apply) \
+	apply(vkGetDeviceProcAddr); \
+	apply(vkGetPhysicalDeviceMemoryProperties); \
+	apply(vkEnumerateDeviceExtensionProperties);
+
+// Functions that dispatch on VkDevice/VkQueue/VkCommandBuffer, resolved through vkGetDeviceProcAddr
+// so that calls jump straight into the driver instead of going through the loader trampoline
+#define VULKAN_DEVICE_API_FUNCTIONS(apply) \
+	apply(vkCreateBuffer); \
+	apply(vkGetBufferMemoryRequirements); \
+	apply(vkMapMemory); \
+	apply(vkBindBufferMemory); \
+	apply(vkAllocateMemory); \
+	apply(vkDestroyBuffer); \
+	apply(vkFreeMemory); \
+	apply(vkUnmapMemory); \
+	apply(vkQueueWaitIdle); \
+	apply(vkDeviceWaitIdle); \
+	apply(vkFlushMappedMemoryRanges); \
+	apply(vkCreatePipelineLayout); \
+	apply(vkCreateShaderModule); \
+	apply(vkDestroyShaderModule); \
+	apply(vkCreateGraphicsPipelines); \
+	apply(vkDestroyPipeline); \
+	apply(vkDestroyPipelineLayout); \
+	apply(vkCreateDescriptorSetLayout); \
+	apply(vkDestroyDescriptorSetLayout); \
+	apply(vkCreateDescriptorPool); \
+	apply(vkDestroyDescriptorPool); \
+	apply(vkAllocateDescriptorSets); \
+	apply(vkUpdateDescriptorSets); \
+	apply(vkCreateSampler); \
+	apply(vkDestroySampler); \
+	apply(vkCreateImageView); \
+	apply(vkDestroyImageView); \
+	apply(vkCreateRenderPass); \
+	apply(vkCreateCommandPool); \
+	apply(vkDestroyCommandPool); \
+	apply(vkResetCommandPool); \
+	apply(vkAllocateCommandBuffers); \
+	apply(vkBeginCommandBuffer); \
+	apply(vkEndCommandBuffer); \
+	apply(vkCmdBeginRenderPass); \
+	apply(vkCmdCopyBufferToImage); \
+	apply(vkCmdBindPipeline); \
+	apply(vkCmdBindDescriptorSets); \
+	apply(vkCmdSetViewport); \
+	apply(vkCmdSetScissor); \
+	apply(vkCmdDraw); \
+	apply(vkCmdPushConstants); \
+	apply(vkCmdBindVertexBuffers);
+
+// Per-device Vulkan function table, owned by the RenderAPI_Vulkan instance that loaded it
+struct VulkanDispatchTable
+{
+#define VULKAN_DECLARE_API_FUNCPTR(func) PFN_##func func = nullptr
+	VULKAN_DECLARE_API_FUNCPTR(vkGetInstanceProcAddr);
+	VULKAN_INSTANCE_API_FUNCTIONS(VULKAN_DECLARE_API_FUNCPTR);
+	VULKAN_DEVICE_API_FUNCTIONS(VULKAN_DECLARE_API_FUNCPTR);
+
+	// Optional entry points, only valid when the matching capability flag is set
+	VULKAN_DECLARE_API_FUNCPTR(vkCmdDrawIndexedIndirectCount);
+	VULKAN_DECLARE_API_FUNCPTR(vkGetPhysicalDeviceMemoryProperties2);
+	VULKAN_DECLARE_API_FUNCPTR(vkGetPhysicalDeviceProperties2); // Core 1.1 or VK_KHR_get_physical_device_properties2, may be null
+	VULKAN_DECLARE_API_FUNCPTR(vkCreateRenderPass2); // Core 1.2 or VK_KHR_create_renderpass2, may be null
+#undef VULKAN_DECLARE_API_FUNCPTR
+
+	// Core 1.2 drawIndirectCount feature or VK_KHR/AMD_draw_indirect_count enabled on the device
+	bool supportsDrawIndirectCount = false;
+	// VK_EXT_memory_budget supported by the physical device, query with vkGetPhysicalDeviceMemoryProperties2
+	bool supportsMemoryBudget = false;
+
+	// Resolve all functions for the device of the given instance. Returns false if a required function is missing.
+	// drawIndirectCountFunction names the vkCmdDrawIndexedIndirectCount variant the device was created with, null when unknown or none.
+	bool Load(const UnityVulkanInstance& instance, const char* drawIndirectCountFunction);
+};
+
+bool HasVulkanDeviceExtension(PFN_vkEnumerateDeviceExtensionProperties enumerateDeviceExtensionProperties, VkPhysicalDevice physicalDevice, const char* extensionName);
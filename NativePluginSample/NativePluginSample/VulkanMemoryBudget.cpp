@@ -0,0 +1,118 @@
+#include "VulkanMemoryBudget.h"
+#include <algorithm>
+
+VulkanMemoryBudget::VulkanMemoryBudget()
+	:m_HeapCount(0), m_MemoryTypeHeap{}, m_Heaps{}, m_HasDriverBudget(false), m_PluginFraction(kDefaultPluginFraction)
+	, m_PluginUsage{}, m_Budget{}, m_ProcessUsage{}, m_PluginUsageAtUpdate{}
+{
+}
+
+void VulkanMemoryBudget::Initialize(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice)
+{
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vk.vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_HeapCount = memoryProperties.memoryHeapCount;
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+			m_MemoryTypeHeap[i] = memoryProperties.memoryTypes[i].heapIndex;
+		for (uint32_t i = 0; i < m_HeapCount; ++i)
+		{
+			m_Heaps[i] = memoryProperties.memoryHeaps[i];
+			m_Budget[i] = m_Heaps[i].size;
+			m_PluginUsage[i] = 0;
+			m_ProcessUsage[i] = 0;
+			m_PluginUsageAtUpdate[i] = 0;
+		}
+		m_HasDriverBudget = vk.supportsMemoryBudget;
+	}
+
+	Update(vk, physicalDevice);
+}
+
+void VulkanMemoryBudget::Update(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice)
+{
+	if (!vk.supportsMemoryBudget)
+		return;
+
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+	budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+	VkPhysicalDeviceMemoryProperties2 memoryProperties = {};
+	memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+	memoryProperties.pNext = &budgetProperties;
+	vk.vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryProperties);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (uint32_t i = 0; i < m_HeapCount; ++i)
+	{
+		// Some drivers report 0 for heaps they do not track
+		m_Budget[i] = budgetProperties.heapBudget[i] != 0 ? budgetProperties.heapBudget[i] : m_Heaps[i].size;
+		m_ProcessUsage[i] = budgetProperties.heapUsage[i];
+		m_PluginUsageAtUpdate[i] = m_PluginUsage[i];
+	}
+}
+
+void VulkanMemoryBudget::OnAllocate(uint32_t heapIndex, VkDeviceSize size)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_PluginUsage[heapIndex] += size;
+}
+
+void VulkanMemoryBudget::OnFree(uint32_t heapIndex, VkDeviceSize size)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_PluginUsage[heapIndex] -= std::min(size, m_PluginUsage[heapIndex]);
+}
+
+void VulkanMemoryBudget::SetPluginFraction(float fraction)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_PluginFraction = std::clamp(fraction, 0.0f, 1.0f);
+}
+
+VkDeviceSize VulkanMemoryBudget::EstimateProcessUsage(uint32_t heapIndex) const
+{
+	// Unity allocations are only seen through the driver, plugin allocations since the last query are applied on top
+	if (m_PluginUsage[heapIndex] >= m_PluginUsageAtUpdate[heapIndex])
+		return m_ProcessUsage[heapIndex] + (m_PluginUsage[heapIndex] - m_PluginUsageAtUpdate[heapIndex]);
+	return m_ProcessUsage[heapIndex] - std::min(m_PluginUsageAtUpdate[heapIndex] - m_PluginUsage[heapIndex], m_ProcessUsage[heapIndex]);
+}
+
+VkDeviceSize VulkanMemoryBudget::GetExcess(uint32_t heapIndex, VkDeviceSize additionalBytes) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (heapIndex >= m_HeapCount)
+		return 0;
+
+	const VkDeviceSize pluginUsage = m_PluginUsage[heapIndex] + additionalBytes;
+	const VkDeviceSize pluginLimit = static_cast<VkDeviceSize>(m_Budget[heapIndex] * static_cast<double>(m_PluginFraction));
+	VkDeviceSize excess = pluginUsage > pluginLimit ? pluginUsage - pluginLimit : 0;
+
+	if (m_HasDriverBudget)
+	{
+		const VkDeviceSize processUsage = EstimateProcessUsage(heapIndex) + additionalBytes;
+		if (processUsage > m_Budget[heapIndex])
+			excess = std::max(excess, processUsage - m_Budget[heapIndex]);
+	}
+
+	return excess;
+}
+
+int VulkanMemoryBudget::GetSnapshot(MemoryHeapBudget* heaps, int maxHeaps) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	const int heapCount = std::min(static_cast<int>(m_HeapCount), std::max(maxHeaps, 0));
+	for (int i = 0; i < heapCount; ++i)
+	{
+		MemoryHeapBudget& heap = heaps[i];
+		heap.size = m_Heaps[i].size;
+		heap.budget = m_Budget[i];
+		heap.pluginUsage = m_PluginUsage[i];
+		heap.pluginLimit = static_cast<unsigned long long>(m_Budget[i] * static_cast<double>(m_PluginFraction));
+		heap.processUsage = m_HasDriverBudget ? EstimateProcessUsage(i) : m_PluginUsage[i];
+		heap.deviceLocal = (m_Heaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? 1 : 0;
+		heap.driverBudget = m_HasDriverBudget ? 1 : 0;
+	}
+	return heapCount;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mutex>
+#include "RenderAPI.h"
+#include "VulkanDispatchTable.h"
+
+// Per-heap view of device memory: what the plugin allocated itself, and what the driver reports for the whole process
+// through VK_EXT_memory_budget. Without the extension the budget is the heap size and only plugin allocations are known.
+// Thread-safe, allocations happen on the render thread and snapshots are taken from the main thread.
+class VulkanMemoryBudget
+{
+public:
+	// Share of a heap budget plugin allocations may use before streamable resources are evicted
+	static constexpr float kDefaultPluginFraction = 0.5f;
+
+	VulkanMemoryBudget();
+
+	void Initialize(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice);
+
+	// Queries the driver budget, called once per frame by the first render event of the frame
+	void Update(const VulkanDispatchTable& vk, VkPhysicalDevice physicalDevice);
+
+	uint32_t GetHeapIndex(uint32_t memoryTypeIndex) const { return m_MemoryTypeHeap[memoryTypeIndex]; }
+
+	void OnAllocate(uint32_t heapIndex, VkDeviceSize size);
+
+	void OnFree(uint32_t heapIndex, VkDeviceSize size);
+
+	void SetPluginFraction(float fraction);
+
+	// Bytes that must be freed from the heap before allocating additionalBytes, 0 when there is no pressure.
+	// Pressure means plugin usage above its share of the budget, or process usage above the whole budget.
+	VkDeviceSize GetExcess(uint32_t heapIndex, VkDeviceSize additionalBytes) const;
+
+	// Returns the number of heaps written
+	int GetSnapshot(MemoryHeapBudget* heaps, int maxHeaps) const;
+
+private:
+	// Caller holds m_Mutex
+	VkDeviceSize EstimateProcessUsage(uint32_t heapIndex) const;
+
+	mutable std::mutex m_Mutex;
+	uint32_t m_HeapCount;
+	uint32_t m_MemoryTypeHeap[VK_MAX_MEMORY_TYPES];
+	VkMemoryHeap m_Heaps[VK_MAX_MEMORY_HEAPS];
+	bool m_HasDriverBudget;
+	float m_PluginFraction;
+
+	VkDeviceSize m_PluginUsage[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize m_Budget[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize m_ProcessUsage[VK_MAX_MEMORY_HEAPS];
+	// Plugin usage at the last driver query, the driver number is only refreshed once per frame
+	VkDeviceSize m_PluginUsageAtUpdate[VK_MAX_MEMORY_HEAPS];
+};
@@ -0,0 +1,1088 @@
+// Replays a capture written by BeginPluginCapture/EndPluginCapture against NativePluginSample.dll without Unity.
+// Acts as a minimal Unity host: it provides the plugin interfaces, creates its own Vulkan device and render targets,
+// and re-drives every recorded call so plugin changes can be profiled and reproduced offline.
+//
+// Usage: PluginReplay <capture> [--plugin <dll>] [--loops <n>] [--device <index>] [--width <w>] [--height <h>] [--verbose]
+// Any Vulkan driver works, including software ones (e.g. set VK_DRIVER_FILES to lavapipe or SwiftShader) on machines without a GPU.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include <IUnityInterface.h>
+#include <IUnityGraphics.h>
+#include <IUnityGraphicsVulkan.h>
+#include <IUnityLog.h>
+#include "PluginCapture.h"
+#include "RenderAPI.h"
+#include "RenderingPlugin.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+typedef void (UNITY_INTERFACE_API* PFN_UnityPluginLoad)(IUnityInterfaces*);
+typedef void (UNITY_INTERFACE_API* PFN_UnityPluginUnload)();
+typedef UnityRenderingEvent (UNITY_INTERFACE_API* PFN_GetRenderEventFunc)();
+typedef void (UNITY_INTERFACE_API* PFN_SetTimeFromUnity)(float);
+typedef void (UNITY_INTERFACE_API* PFN_SetMaterialFromUnity)(int);
+typedef int (UNITY_INTERFACE_API* PFN_CreateBindlessBuffer)(const void*, int);
+typedef void (UNITY_INTERFACE_API* PFN_ReleaseBindlessResource)(int);
+
+struct PluginExports
+{
+	PFN_UnityPluginLoad UnityPluginLoad;
+	PFN_UnityPluginUnload UnityPluginUnload;
+	PFN_GetRenderEventFunc GetRenderEventFunc;
+	PFN_SetTimeFromUnity SetTimeFromUnity;
+	PFN_SetMaterialFromUnity SetMaterialFromUnity;
+	PFN_CreateBindlessBuffer CreateBindlessBuffer;
+	PFN_ReleaseBindlessResource ReleaseBindlessBuffer;
+	PFN_ReleaseBindlessResource ReleaseBindlessTexture;
+};
+
+// Attachments of a recreated render pass, sized to the replay resolution
+struct ReplayRenderPass
+{
+	VkRenderPass renderPass;
+	VkFramebuffer framebuffer;
+	uint32_t subpassCount;
+	std::vector<VkImage> images;
+	std::vector<VkImageView> imageViews;
+	std::vector<VkDeviceMemory> memories;
+};
+
+struct ReplayFrame
+{
+	VkCommandPool commandPool;
+	VkCommandBuffer commandBuffer;
+	VkFence fence;
+	unsigned long long frameNumber;
+};
+
+static const int kFramesInFlight = 3;
+// Used when a render pass was created before the plugin could intercept it, or an event needs one while outside
+static const uint64_t kDefaultRenderPassID = ~0ull;
+
+//=============================================================================================================================================================
+// Host state, shared with the interface callbacks the plugin calls into
+
+static bool s_Verbose = false;
+static UnityGfxRenderer s_Renderer = kUnityGfxRendererNull;
+static std::vector<IUnityGraphicsDeviceEventCallback> s_DeviceEventCallbacks;
+static UnityVulkanInitCallback s_InitCallback = nullptr;
+static void* s_InitCallbackUserData = nullptr;
+static std::unordered_map<int, UnityVulkanPluginEventConfig> s_EventConfigs;
+static UnityVulkanInstance s_Instance = {};
+
+static uint32_t s_Width = 1920;
+static uint32_t s_Height = 1080;
+static std::unordered_map<uint64_t, ReplayRenderPass> s_RenderPasses;
+static ReplayFrame s_Frames[kFramesInFlight] = {};
+static ReplayFrame* s_CurrentFrame = nullptr;
+static unsigned long long s_FrameNumber = 0;
+static unsigned long long s_SafeFrameNumber = 0;
+
+// Render pass the captured events ran in, and the one currently begun on the replay command buffer
+static uint64_t s_TargetRenderPass = 0;
+static int s_TargetSubpass = 0;
+static const ReplayRenderPass* s_ActiveRenderPass = nullptr;
+static int s_ActiveSubpass = 0;
+
+//=============================================================================================================================================================
+// Unity interfaces
+
+static void UNITY_INTERFACE_API HostLog(UnityLogType type, const char* message, const char* fileName, const int fileLine)
+{
+	if (type == kUnityLogTypeLog && !s_Verbose)
+		return;
+
+	const char* prefix = type == kUnityLogTypeError || type == kUnityLogTypeException ? "Error" : type == kUnityLogTypeWarning ? "Warning" : "Log";
+	printf("[Plugin %s] %s\n", prefix, message);
+}
+
+static UnityGfxRenderer UNITY_INTERFACE_API HostGetRenderer()
+{
+	return s_Renderer;
+}
+
+static void UNITY_INTERFACE_API HostRegisterDeviceEventCallback(IUnityGraphicsDeviceEventCallback callback)
+{
+	s_DeviceEventCallbacks.push_back(callback);
+}
+
+static void UNITY_INTERFACE_API HostUnregisterDeviceEventCallback(IUnityGraphicsDeviceEventCallback callback)
+{
+	for (auto it = s_DeviceEventCallbacks.begin(); it != s_DeviceEventCallbacks.end(); ++it)
+	{
+		if (*it == callback)
+		{
+			s_DeviceEventCallbacks.erase(it);
+			break;
+		}
+	}
+}
+
+static int UNITY_INTERFACE_API HostReserveEventIDRange(int count)
+{
+	static int nextEventID = 1 << 16;
+	const int first = nextEventID;
+	nextEventID += count;
+	return first;
+}
+
+static bool UNITY_INTERFACE_API HostInterceptInitialization(UnityVulkanInitCallback func, void* userdata)
+{
+	s_InitCallback = func;
+	s_InitCallbackUserData = userdata;
+	return true;
+}
+
+// The replay records straight through the loader, there is no Unity-side function table to patch
+static PFN_vkVoidFunction UNITY_INTERFACE_API HostInterceptVulkanAPI(const char* name, PFN_vkVoidFunction func)
+{
+	return nullptr;
+}
+
+static void UNITY_INTERFACE_API HostConfigureEvent(int eventID, const UnityVulkanPluginEventConfig* pluginEventConfig)
+{
+	s_EventConfigs[eventID] = *pluginEventConfig;
+}
+
+static UnityVulkanInstance UNITY_INTERFACE_API HostInstance()
+{
+	return s_Instance;
+}
+
+static bool UNITY_INTERFACE_API HostCommandRecordingState(UnityVulkanRecordingState* outCommandRecordingState, UnityVulkanGraphicsQueueAccess queueAccess)
+{
+	if (!s_CurrentFrame)
+		return false;
+
+	*outCommandRecordingState = UnityVulkanRecordingState();
+	outCommandRecordingState->commandBuffer = s_CurrentFrame->commandBuffer;
+	outCommandRecordingState->commandBufferLevel = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	outCommandRecordingState->renderPass = s_ActiveRenderPass ? s_ActiveRenderPass->renderPass : VK_NULL_HANDLE;
+	outCommandRecordingState->framebuffer = s_ActiveRenderPass ? s_ActiveRenderPass->framebuffer : VK_NULL_HANDLE;
+	outCommandRecordingState->subPassIndex = s_ActiveSubpass;
+	outCommandRecordingState->currentFrameNumber = s_FrameNumber;
+	outCommandRecordingState->safeFrameNumber = s_SafeFrameNumber;
+	return true;
+}
+
+// Unity textures are not part of a capture
+static bool UNITY_INTERFACE_API HostAccessTexture(void* nativeTexture, const VkImageSubresource* subResource, VkImageLayout layout,
+	VkPipelineStageFlags pipelineStageFlags, VkAccessFlags accessFlags, UnityVulkanResourceAccessMode accessMode, UnityVulkanImage* outImage)
+{
+	return false;
+}
+
+static IUnityGraphics s_Graphics = {};
+static IUnityGraphicsVulkan s_GraphicsVulkan = {};
+static IUnityLog s_Log = {};
+
+static IUnityInterface* UNITY_INTERFACE_API HostGetInterfaceSplit(unsigned long long guidHigh, unsigned long long guidLow)
+{
+	const UnityInterfaceGUID guid(guidHigh, guidLow);
+	if (guid == UNITY_GET_INTERFACE_GUID(IUnityGraphics))
+		return &s_Graphics;
+	if (guid == UNITY_GET_INTERFACE_GUID(IUnityGraphicsVulkan))
+		return &s_GraphicsVulkan;
+	if (guid == UNITY_GET_INTERFACE_GUID(IUnityLog))
+		return &s_Log;
+	return nullptr;
+}
+
+static IUnityInterface* UNITY_INTERFACE_API HostGetInterface(UnityInterfaceGUID guid)
+{
+	return HostGetInterfaceSplit(guid.m_GUIDHigh, guid.m_GUIDLow);
+}
+
+static void UNITY_INTERFACE_API HostRegisterInterface(UnityInterfaceGUID guid, IUnityInterface* ptr)
+{
+}
+
+static void UNITY_INTERFACE_API HostRegisterInterfaceSplit(unsigned long long guidHigh, unsigned long long guidLow, IUnityInterface* ptr)
+{
+}
+
+static void SendDeviceEvent(UnityGfxDeviceEventType eventType)
+{
+	// Copied, the plugin unregisters itself on unload
+	const std::vector<IUnityGraphicsDeviceEventCallback> callbacks = s_DeviceEventCallbacks;
+	for (IUnityGraphicsDeviceEventCallback callback : callbacks)
+		callback(eventType);
+}
+
+//=============================================================================================================================================================
+// Plugin library
+
+static void* LoadPluginLibrary(const char* path)
+{
+#ifdef _WIN32
+	return (void*)LoadLibraryA(path);
+#else
+	return dlopen(path, RTLD_NOW);
+#endif
+}
+
+static void UnloadPluginLibrary(void* library)
+{
+#ifdef _WIN32
+	FreeLibrary((HMODULE)library);
+#else
+	dlclose(library);
+#endif
+}
+
+static void* GetPluginFunction(void* library, const char* name)
+{
+#ifdef _WIN32
+	return (void*)GetProcAddress((HMODULE)library, name);
+#else
+	return dlsym(library, name);
+#endif
+}
+
+static bool LoadPluginExports(void* library, PluginExports* exports)
+{
+	bool success = true;
+#define LOAD_PLUGIN_FUNC(fn) exports->fn = (PFN_##fn)GetPluginFunction(library, #fn); success = success && exports->fn != nullptr
+	LOAD_PLUGIN_FUNC(UnityPluginLoad);
+	LOAD_PLUGIN_FUNC(UnityPluginUnload);
+	LOAD_PLUGIN_FUNC(GetRenderEventFunc);
+	LOAD_PLUGIN_FUNC(SetTimeFromUnity);
+	LOAD_PLUGIN_FUNC(SetMaterialFromUnity);
+	LOAD_PLUGIN_FUNC(CreateBindlessBuffer);
+#undef LOAD_PLUGIN_FUNC
+	exports->ReleaseBindlessBuffer = (PFN_ReleaseBindlessResource)GetPluginFunction(library, "ReleaseBindlessBuffer");
+	exports->ReleaseBindlessTexture = (PFN_ReleaseBindlessResource)GetPluginFunction(library, "ReleaseBindlessTexture");
+	return success && exports->ReleaseBindlessBuffer && exports->ReleaseBindlessTexture;
+}
+
+//=============================================================================================================================================================
+// Vulkan device and render targets
+
+static bool CreateVulkanDevice(uint32_t deviceIndex)
+{
+	// Same order as Unity: the plugin hooks instance/device creation through the intercepted vkGetInstanceProcAddr
+	PFN_vkGetInstanceProcAddr getInstanceProcAddr = vkGetInstanceProcAddr;
+	if (s_InitCallback)
+		getInstanceProcAddr = s_InitCallback(vkGetInstanceProcAddr, s_InitCallbackUserData);
+
+	VkApplicationInfo applicationInfo = {};
+	applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	applicationInfo.pApplicationName = "PluginReplay";
+	applicationInfo.apiVersion = VK_API_VERSION_1_2;
+
+	VkInstanceCreateInfo instanceCreateInfo = {};
+	instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	instanceCreateInfo.pApplicationInfo = &applicationInfo;
+
+	PFN_vkCreateInstance createInstance = (PFN_vkCreateInstance)getInstanceProcAddr(VK_NULL_HANDLE, "vkCreateInstance");
+	if (!createInstance || createInstance(&instanceCreateInfo, nullptr, &s_Instance.instance) != VK_SUCCESS)
+	{
+		printf("Failed to create Vulkan instance\n");
+		return false;
+	}
+
+	uint32_t physicalDeviceCount = 0;
+	vkEnumeratePhysicalDevices(s_Instance.instance, &physicalDeviceCount, nullptr);
+	std::vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
+	vkEnumeratePhysicalDevices(s_Instance.instance, &physicalDeviceCount, physicalDevices.data());
+	if (deviceIndex >= physicalDeviceCount)
+	{
+		printf("Vulkan device %u not found, %u available\n", deviceIndex, physicalDeviceCount);
+		return false;
+	}
+	s_Instance.physicalDevice = physicalDevices[deviceIndex];
+
+	VkPhysicalDeviceProperties physicalDeviceProperties;
+	vkGetPhysicalDeviceProperties(s_Instance.physicalDevice, &physicalDeviceProperties);
+	printf("Vulkan device: %s\n", physicalDeviceProperties.deviceName);
+
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(s_Instance.physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(s_Instance.physicalDevice, &queueFamilyCount, queueFamilies.data());
+	s_Instance.queueFamilyIndex = queueFamilyCount;
+	for (uint32_t i = 0; i < queueFamilyCount; ++i)
+	{
+		if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+		{
+			s_Instance.queueFamilyIndex = i;
+			break;
+		}
+	}
+	if (s_Instance.queueFamilyIndex == queueFamilyCount)
+	{
+		printf("Vulkan device has no graphics queue\n");
+		return false;
+	}
+
+	const float queuePriority = 1.0f;
+	VkDeviceQueueCreateInfo queueCreateInfo = {};
+	queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueCreateInfo.queueFamilyIndex = s_Instance.queueFamilyIndex;
+	queueCreateInfo.queueCount = 1;
+	queueCreateInfo.pQueuePriorities = &queuePriority;
+
+	VkDeviceCreateInfo deviceCreateInfo = {};
+	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceCreateInfo.queueCreateInfoCount = 1;
+	deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+
+	PFN_vkCreateDevice createDevice = (PFN_vkCreateDevice)getInstanceProcAddr(s_Instance.instance, "vkCreateDevice");
+	if (!createDevice || createDevice(s_Instance.physicalDevice, &deviceCreateInfo, nullptr, &s_Instance.device) != VK_SUCCESS)
+	{
+		printf("Failed to create Vulkan device\n");
+		return false;
+	}
+
+	vkGetDeviceQueue(s_Instance.device, s_Instance.queueFamilyIndex, 0, &s_Instance.graphicsQueue);
+	s_Instance.getInstanceProcAddr = vkGetInstanceProcAddr;
+
+	for (ReplayFrame& frame : s_Frames)
+	{
+		VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = s_Instance.queueFamilyIndex;
+		if (vkCreateCommandPool(s_Instance.device, &commandPoolCreateInfo, nullptr, &frame.commandPool) != VK_SUCCESS)
+			return false;
+
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.commandPool = frame.commandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(s_Instance.device, &commandBufferAllocateInfo, &frame.commandBuffer) != VK_SUCCESS)
+			return false;
+
+		VkFenceCreateInfo fenceCreateInfo = {};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+		if (vkCreateFence(s_Instance.device, &fenceCreateInfo, nullptr, &frame.fence) != VK_SUCCESS)
+			return false;
+	}
+
+	return true;
+}
+
+static int FindMemoryTypeIndex(const VkMemoryRequirements& memoryRequirements, VkMemoryPropertyFlags memoryPropertyFlags)
+{
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(s_Instance.physicalDevice, &memoryProperties);
+	for (uint32_t memoryTypeIndex = 0; memoryTypeIndex < memoryProperties.memoryTypeCount; ++memoryTypeIndex)
+	{
+		if ((memoryRequirements.memoryTypeBits & (1u << memoryTypeIndex))
+			&& (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & memoryPropertyFlags) == memoryPropertyFlags)
+			return memoryTypeIndex;
+	}
+	return -1;
+}
+
+static VkImageAspectFlags GetDepthAspect(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_D16_UNORM_S8_UINT:
+	case VK_FORMAT_D24_UNORM_S8_UINT:
+	case VK_FORMAT_D32_SFLOAT_S8_UINT:
+		return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+	case VK_FORMAT_S8_UINT:
+		return VK_IMAGE_ASPECT_STENCIL_BIT;
+	default:
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+}
+
+static bool CreateAttachment(ReplayRenderPass* renderPass, VkFormat format, VkSampleCountFlagBits samples, bool depth)
+{
+	VkImageCreateInfo imageCreateInfo = {};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format = format;
+	imageCreateInfo.extent = { s_Width, s_Height, 1 };
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.samples = samples;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	// Any attachment may also be read as an input attachment by a later subpass
+	imageCreateInfo.usage = (depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VkImage image;
+	if (vkCreateImage(s_Instance.device, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
+		return false;
+	renderPass->images.push_back(image);
+
+	VkMemoryRequirements memoryRequirements;
+	vkGetImageMemoryRequirements(s_Instance.device, image, &memoryRequirements);
+	int memoryTypeIndex = FindMemoryTypeIndex(memoryRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	if (memoryTypeIndex < 0)
+		memoryTypeIndex = FindMemoryTypeIndex(memoryRequirements, 0);
+
+	VkMemoryAllocateInfo memoryAllocateInfo = {};
+	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.allocationSize = memoryRequirements.size;
+	memoryAllocateInfo.memoryTypeIndex = static_cast<uint32_t>(memoryTypeIndex);
+
+	VkDeviceMemory memory;
+	if (memoryTypeIndex < 0 || vkAllocateMemory(s_Instance.device, &memoryAllocateInfo, nullptr, &memory) != VK_SUCCESS)
+		return false;
+	renderPass->memories.push_back(memory);
+
+	if (vkBindImageMemory(s_Instance.device, image, memory, 0) != VK_SUCCESS)
+		return false;
+
+	VkImageViewCreateInfo imageViewCreateInfo = {};
+	imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.image = image;
+	imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	imageViewCreateInfo.format = format;
+	imageViewCreateInfo.subresourceRange.aspectMask = depth ? GetDepthAspect(format) : VK_IMAGE_ASPECT_COLOR_BIT;
+	imageViewCreateInfo.subresourceRange.levelCount = 1;
+	imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+	VkImageView imageView;
+	if (vkCreateImageView(s_Instance.device, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
+		return false;
+	renderPass->imageViews.push_back(imageView);
+
+	return true;
+}
+
+static void DestroyRenderPass(ReplayRenderPass& renderPass)
+{
+	if (renderPass.framebuffer != VK_NULL_HANDLE)
+		vkDestroyFramebuffer(s_Instance.device, renderPass.framebuffer, nullptr);
+	if (renderPass.renderPass != VK_NULL_HANDLE)
+		vkDestroyRenderPass(s_Instance.device, renderPass.renderPass, nullptr);
+	for (VkImageView imageView : renderPass.imageViews)
+		vkDestroyImageView(s_Instance.device, imageView, nullptr);
+	for (VkImage image : renderPass.images)
+		vkDestroyImage(s_Instance.device, image, nullptr);
+	for (VkDeviceMemory memory : renderPass.memories)
+		vkFreeMemory(s_Instance.device, memory, nullptr);
+	renderPass = ReplayRenderPass();
+}
+
+// Compatible with the captured render pass (same formats, sample counts and references), so plugin pipelines created against it are valid
+static bool CreateRenderPass(const CapturedRenderPass& captured, ReplayRenderPass* renderPass)
+{
+	*renderPass = ReplayRenderPass();
+
+	std::vector<bool> isDepth(captured.attachments.size(), false);
+	for (const CapturedRenderPass::Subpass& subpass : captured.subpasses)
+	{
+		if (subpass.depthAttachment < isDepth.size())
+			isDepth[subpass.depthAttachment] = true;
+	}
+
+	std::vector<VkAttachmentDescription> attachments;
+	for (size_t i = 0; i < captured.attachments.size(); ++i)
+	{
+		VkAttachmentDescription attachment = {};
+		attachment.format = (VkFormat)captured.attachments[i].format;
+		attachment.samples = (VkSampleCountFlagBits)captured.attachments[i].samples;
+		attachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachment.finalLayout = isDepth[i] ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachments.push_back(attachment);
+
+		if (!CreateAttachment(renderPass, attachment.format, attachment.samples, isDepth[i]))
+		{
+			DestroyRenderPass(*renderPass);
+			return false;
+		}
+	}
+
+	std::vector<std::vector<VkAttachmentReference>> colorReferences(captured.subpasses.size());
+	std::vector<VkAttachmentReference> depthReferences(captured.subpasses.size());
+	std::vector<std::vector<VkAttachmentReference>> inputReferences(captured.subpasses.size());
+	std::vector<std::vector<VkAttachmentReference>> resolveReferences(captured.subpasses.size());
+	std::vector<VkSubpassDescription> subpasses(captured.subpasses.size());
+	for (size_t i = 0; i < captured.subpasses.size(); ++i)
+	{
+		const CapturedRenderPass::Subpass& subpass = captured.subpasses[i];
+		for (uint32_t colorAttachment : subpass.colorAttachments)
+			colorReferences[i].push_back({ colorAttachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+		depthReferences[i] = { subpass.depthAttachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+		for (uint32_t inputAttachment : subpass.inputAttachments)
+		{
+			const bool depth = inputAttachment < isDepth.size() && isDepth[inputAttachment];
+			inputReferences[i].push_back({ inputAttachment, depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+		}
+		// A malformed resolve list would make vkCreateRenderPass read past it, drop it instead
+		if (subpass.resolveAttachments.size() == subpass.colorAttachments.size())
+		{
+			for (uint32_t resolveAttachment : subpass.resolveAttachments)
+				resolveReferences[i].push_back({ resolveAttachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL });
+		}
+
+		subpasses[i].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpasses[i].colorAttachmentCount = static_cast<uint32_t>(colorReferences[i].size());
+		subpasses[i].pColorAttachments = colorReferences[i].data();
+		subpasses[i].pResolveAttachments = resolveReferences[i].empty() ? nullptr : resolveReferences[i].data();
+		subpasses[i].pDepthStencilAttachment = depthReferences[i].attachment != VK_ATTACHMENT_UNUSED ? &depthReferences[i] : nullptr;
+		subpasses[i].inputAttachmentCount = static_cast<uint32_t>(inputReferences[i].size());
+		subpasses[i].pInputAttachments = inputReferences[i].data();
+	}
+
+	VkRenderPassCreateInfo renderPassCreateInfo = {};
+	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+	renderPassCreateInfo.pAttachments = attachments.data();
+	renderPassCreateInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+	renderPassCreateInfo.pSubpasses = subpasses.data();
+	if (vkCreateRenderPass(s_Instance.device, &renderPassCreateInfo, nullptr, &renderPass->renderPass) != VK_SUCCESS)
+	{
+		DestroyRenderPass(*renderPass);
+		return false;
+	}
+
+	VkFramebufferCreateInfo framebufferCreateInfo = {};
+	framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.renderPass = renderPass->renderPass;
+	framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(renderPass->imageViews.size());
+	framebufferCreateInfo.pAttachments = renderPass->imageViews.data();
+	framebufferCreateInfo.width = s_Width;
+	framebufferCreateInfo.height = s_Height;
+	framebufferCreateInfo.layers = 1;
+	if (vkCreateFramebuffer(s_Instance.device, &framebufferCreateInfo, nullptr, &renderPass->framebuffer) != VK_SUCCESS)
+	{
+		DestroyRenderPass(*renderPass);
+		return false;
+	}
+
+	renderPass->subpassCount = renderPassCreateInfo.subpassCount;
+	return true;
+}
+
+// Color + reverse-Z depth target like Unity's default camera target
+static CapturedRenderPass GetDefaultRenderPass(uint64_t id)
+{
+	CapturedRenderPass renderPass;
+	renderPass.id = id;
+	renderPass.attachments.push_back({ VK_FORMAT_B8G8R8A8_UNORM, VK_SAMPLE_COUNT_1_BIT });
+	renderPass.attachments.push_back({ VK_FORMAT_D32_SFLOAT, VK_SAMPLE_COUNT_1_BIT });
+	renderPass.subpasses.push_back({ { 0 }, 1 });
+	return renderPass;
+}
+
+static void AddRenderPass(const CapturedRenderPass& captured)
+{
+	if (captured.id == 0 || s_RenderPasses.count(captured.id))
+		return;
+
+	ReplayRenderPass renderPass;
+	if (!captured.attachments.empty() && CreateRenderPass(captured, &renderPass))
+	{
+		s_RenderPasses[captured.id] = renderPass;
+		return;
+	}
+
+	if (!captured.attachments.empty())
+		printf("Render pass %llx could not be recreated, using the default render pass\n", (unsigned long long)captured.id);
+	if (CreateRenderPass(GetDefaultRenderPass(captured.id), &renderPass))
+		s_RenderPasses[captured.id] = renderPass;
+}
+
+//=============================================================================================================================================================
+// Frame and render pass state, mirrors what Unity sets up around plugin events
+
+static void EndRenderPass()
+{
+	if (!s_ActiveRenderPass)
+		return;
+
+	vkCmdEndRenderPass(s_CurrentFrame->commandBuffer);
+	s_ActiveRenderPass = nullptr;
+	s_ActiveSubpass = 0;
+}
+
+static void BeginFrame()
+{
+	ReplayFrame& frame = s_Frames[s_FrameNumber % kFramesInFlight];
+	vkWaitForFences(s_Instance.device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+	if (frame.frameNumber > s_SafeFrameNumber)
+		s_SafeFrameNumber = frame.frameNumber;
+
+	vkResetFences(s_Instance.device, 1, &frame.fence);
+	vkResetCommandPool(s_Instance.device, frame.commandPool, 0);
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(frame.commandBuffer, &beginInfo);
+
+	frame.frameNumber = ++s_FrameNumber;
+	s_CurrentFrame = &frame;
+}
+
+static void EndFrame()
+{
+	if (!s_CurrentFrame)
+		return;
+
+	EndRenderPass();
+	vkEndCommandBuffer(s_CurrentFrame->commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &s_CurrentFrame->commandBuffer;
+	vkQueueSubmit(s_Instance.graphicsQueue, 1, &submitInfo, s_CurrentFrame->fence);
+
+	s_CurrentFrame = nullptr;
+}
+
+static void EnsureInsideRenderPass()
+{
+	const uint64_t target = s_TargetRenderPass != 0 ? s_TargetRenderPass : kDefaultRenderPassID;
+	auto it = s_RenderPasses.find(target);
+	if (it == s_RenderPasses.end())
+	{
+		AddRenderPass(GetDefaultRenderPass(target));
+		it = s_RenderPasses.find(target);
+		if (it == s_RenderPasses.end())
+			return;
+	}
+
+	const ReplayRenderPass& renderPass = it->second;
+	const int subpass = s_TargetSubpass < static_cast<int>(renderPass.subpassCount) ? s_TargetSubpass : 0;
+	if (s_ActiveRenderPass != &renderPass || s_ActiveSubpass > subpass)
+	{
+		EndRenderPass();
+
+		VkRenderPassBeginInfo renderPassBeginInfo = {};
+		renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassBeginInfo.renderPass = renderPass.renderPass;
+		renderPassBeginInfo.framebuffer = renderPass.framebuffer;
+		renderPassBeginInfo.renderArea.extent = { s_Width, s_Height };
+		vkCmdBeginRenderPass(s_CurrentFrame->commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		s_ActiveRenderPass = &renderPass;
+		s_ActiveSubpass = 0;
+
+		// Plugin pipelines use dynamic viewport and scissor and rely on Unity having set them for the whole target
+		VkViewport viewport = {};
+		viewport.width = static_cast<float>(s_Width);
+		viewport.height = static_cast<float>(s_Height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport(s_CurrentFrame->commandBuffer, 0, 1, &viewport);
+
+		VkRect2D scissor = {};
+		scissor.extent = { s_Width, s_Height };
+		vkCmdSetScissor(s_CurrentFrame->commandBuffer, 0, 1, &scissor);
+	}
+
+	while (s_ActiveSubpass < subpass)
+	{
+		vkCmdNextSubpass(s_CurrentFrame->commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+		++s_ActiveSubpass;
+	}
+}
+
+//=============================================================================================================================================================
+// Capture parsing
+
+class CaptureReader
+{
+public:
+	CaptureReader(const std::vector<char>& data) : m_Data(data), m_Offset(0) {}
+
+	bool AtEnd() const { return m_Offset >= m_Data.size(); }
+
+	size_t GetOffset() const { return m_Offset; }
+
+	void Seek(size_t offset) { m_Offset = offset; }
+
+	template<typename T>
+	bool Read(T* value)
+	{
+		return ReadBytes(value, sizeof(T));
+	}
+
+	bool ReadBytes(void* data, size_t sizeInBytes)
+	{
+		if (m_Data.size() - m_Offset < sizeInBytes)
+			return false;
+		memcpy(data, m_Data.data() + m_Offset, sizeInBytes);
+		m_Offset += sizeInBytes;
+		return true;
+	}
+
+	bool ReadRenderPass(CapturedRenderPass* renderPass)
+	{
+		uint32_t attachmentCount;
+		if (!Read(&renderPass->id) || !Read(&attachmentCount))
+			return false;
+		renderPass->attachments.resize(attachmentCount);
+		for (CapturedRenderPass::Attachment& attachment : renderPass->attachments)
+		{
+			if (!Read(&attachment.format) || !Read(&attachment.samples))
+				return false;
+		}
+
+		uint32_t subpassCount;
+		if (!Read(&subpassCount))
+			return false;
+		renderPass->subpasses.resize(subpassCount);
+		for (CapturedRenderPass::Subpass& subpass : renderPass->subpasses)
+		{
+			uint32_t colorCount;
+			if (!Read(&colorCount))
+				return false;
+			subpass.colorAttachments.resize(colorCount);
+			for (uint32_t& colorAttachment : subpass.colorAttachments)
+			{
+				if (!Read(&colorAttachment))
+					return false;
+			}
+			if (!Read(&subpass.depthAttachment))
+				return false;
+
+			uint32_t inputCount;
+			if (!Read(&inputCount))
+				return false;
+			subpass.inputAttachments.resize(inputCount);
+			for (uint32_t& inputAttachment : subpass.inputAttachments)
+			{
+				if (!Read(&inputAttachment))
+					return false;
+			}
+
+			uint32_t resolveCount;
+			if (!Read(&resolveCount))
+				return false;
+			subpass.resolveAttachments.resize(resolveCount);
+			for (uint32_t& resolveAttachment : subpass.resolveAttachments)
+			{
+				if (!Read(&resolveAttachment))
+					return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	const std::vector<char>& m_Data;
+	size_t m_Offset;
+};
+
+struct ReplayStats
+{
+	unsigned long long frames = 0;
+	unsigned long long renderEvents = 0;
+	unsigned long long skippedTextures = 0;
+	double renderEventSeconds = 0.0;
+	double cleanupSeconds = 0.0; // releasing resources between loops, not part of the capture
+};
+
+// The plugin only frees released bindless slots in UpdateBindlessTable, once the GPU has finished the frames that used them.
+// Captures without that event would run out of slots after a few loops, so run it until the releases have drained.
+static void FlushBindlessReleases(UnityRenderingEvent renderEvent)
+{
+	for (int i = 0; i < kFramesInFlight + 2; ++i)
+	{
+		EndFrame();
+		BeginFrame();
+		renderEvent(kRenderEventUpdateBindlessTable);
+	}
+	EndFrame();
+}
+
+// Replays every record once. Bindless handles are remapped because the replay table may hand out different slots.
+static bool ReplayCapture(CaptureReader& reader, const PluginExports& plugin, UnityRenderingEvent renderEvent, ReplayStats* stats)
+{
+	std::unordered_map<int, int> bufferHandles;
+	std::unordered_map<int, int> textureHandles;
+	std::vector<char> payload;
+
+	while (!reader.AtEnd())
+	{
+		uint8_t recordType;
+		if (!reader.Read(&recordType))
+			return false;
+
+		switch (recordType)
+		{
+		case kCaptureDeviceEvent:
+		{
+			int32_t eventType;
+			if (!reader.Read(&eventType))
+				return false;
+			break;
+		}
+		case kCaptureTime:
+		{
+			float time;
+			if (!reader.Read(&time))
+				return false;
+			plugin.SetTimeFromUnity(time);
+			break;
+		}
+		case kCaptureMaterial:
+		{
+			// Material handles are bindless buffer slots and are remapped like the buffers.
+			// Buffers created before the capture started do not exist in the replay.
+			int32_t handle;
+			if (!reader.Read(&handle))
+				return false;
+			auto it = bufferHandles.find(handle);
+			plugin.SetMaterialFromUnity(handle < 0 ? handle : (it != bufferHandles.end() ? it->second : -1));
+			break;
+		}
+		case kCaptureRenderEvent:
+		{
+			int32_t eventID;
+			if (!reader.Read(&eventID))
+				return false;
+
+			if (!s_CurrentFrame)
+				BeginFrame();
+
+			auto config = s_EventConfigs.find(eventID);
+			if (config != s_EventConfigs.end())
+			{
+				if (config->second.renderPassPrecondition == kUnityVulkanRenderPass_EnsureInside)
+					EnsureInsideRenderPass();
+				else if (config->second.renderPassPrecondition == kUnityVulkanRenderPass_EnsureOutside)
+					EndRenderPass();
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			renderEvent(eventID);
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			stats->renderEventSeconds += elapsed.count();
+			++stats->renderEvents;
+			break;
+		}
+		case kCaptureFrame:
+		{
+			uint64_t frameNumber;
+			if (!reader.Read(&frameNumber))
+				return false;
+			EndFrame();
+			BeginFrame();
+			++stats->frames;
+			break;
+		}
+		case kCaptureRenderPass:
+		{
+			CapturedRenderPass renderPass;
+			if (!reader.ReadRenderPass(&renderPass))
+				return false;
+			AddRenderPass(renderPass);
+			break;
+		}
+		case kCaptureRecordingState:
+		{
+			uint64_t renderPass;
+			int32_t subpassIndex;
+			if (!reader.Read(&renderPass) || !reader.Read(&subpassIndex))
+				return false;
+			s_TargetRenderPass = renderPass;
+			s_TargetSubpass = subpassIndex;
+			break;
+		}
+		case kCaptureBindlessBuffer:
+		{
+			int32_t handle;
+			uint32_t sizeInBytes;
+			if (!reader.Read(&handle) || !reader.Read(&sizeInBytes))
+				return false;
+			payload.resize(sizeInBytes);
+			if (!reader.ReadBytes(payload.data(), sizeInBytes))
+				return false;
+			bufferHandles[handle] = plugin.CreateBindlessBuffer(payload.data(), static_cast<int>(sizeInBytes));
+			break;
+		}
+		case kCaptureBindlessTexture:
+		{
+			int32_t handle;
+			if (!reader.Read(&handle))
+				return false;
+			textureHandles[handle] = -1;
+			++stats->skippedTextures;
+			break;
+		}
+		case kCaptureBindlessRelease:
+		{
+			uint8_t type;
+			int32_t handle;
+			if (!reader.Read(&type) || !reader.Read(&handle))
+				return false;
+
+			std::unordered_map<int, int>& handles = type == kBindlessBuffer ? bufferHandles : textureHandles;
+			auto it = handles.find(handle);
+			if (it == handles.end())
+				break;
+			if (it->second >= 0)
+				(type == kBindlessBuffer ? plugin.ReleaseBindlessBuffer : plugin.ReleaseBindlessTexture)(it->second);
+			handles.erase(it);
+			break;
+		}
+		default:
+			printf("Unknown record type %u at offset %zu\n", recordType, reader.GetOffset() - 1);
+			return false;
+		}
+	}
+
+	// Resources still alive at the end of the capture would pile up across loops
+	const auto cleanupStart = std::chrono::steady_clock::now();
+	for (const auto& handle : bufferHandles)
+	{
+		if (handle.second >= 0)
+			plugin.ReleaseBindlessBuffer(handle.second);
+	}
+	FlushBindlessReleases(renderEvent);
+	const std::chrono::duration<double> cleanupElapsed = std::chrono::steady_clock::now() - cleanupStart;
+	stats->cleanupSeconds += cleanupElapsed.count();
+
+	return true;
+}
+
+//=============================================================================================================================================================
+
+int main(int argc, char** argv)
+{
+	const char* capturePath = nullptr;
+	const char* pluginPath = "NativePluginSample.dll";
+	int loops = 1;
+	uint32_t deviceIndex = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--plugin") == 0 && i + 1 < argc)
+			pluginPath = argv[++i];
+		else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+			loops = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc)
+			deviceIndex = static_cast<uint32_t>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+			s_Width = static_cast<uint32_t>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc)
+			s_Height = static_cast<uint32_t>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "--verbose") == 0)
+			s_Verbose = true;
+		else
+			capturePath = argv[i];
+	}
+
+	if (!capturePath || loops <= 0 || s_Width == 0 || s_Height == 0)
+	{
+		printf("Usage: PluginReplay <capture> [--plugin <dll>] [--loops <n>] [--device <index>] [--width <w>] [--height <h>] [--verbose]\n");
+		return 1;
+	}
+
+	std::ifstream file(capturePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		printf("Failed to open capture %s\n", capturePath);
+		return 1;
+	}
+	std::vector<char> capture(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(capture.data(), static_cast<std::streamsize>(capture.size()));
+	file.close();
+
+	CaptureReader reader(capture);
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	if (!reader.Read(&magic) || !reader.Read(&version) || magic != kCaptureMagic || version != kCaptureVersion)
+	{
+		printf("%s is not a plugin capture (version %u expected)\n", capturePath, kCaptureVersion);
+		return 1;
+	}
+	const size_t firstRecord = reader.GetOffset();
+
+	void* library = LoadPluginLibrary(pluginPath);
+	PluginExports plugin = {};
+	if (!library || !LoadPluginExports(library, &plugin))
+	{
+		printf("Failed to load plugin %s\n", pluginPath);
+		return 1;
+	}
+
+	s_Graphics.GetRenderer = HostGetRenderer;
+	s_Graphics.RegisterDeviceEventCallback = HostRegisterDeviceEventCallback;
+	s_Graphics.UnregisterDeviceEventCallback = HostUnregisterDeviceEventCallback;
+	s_Graphics.ReserveEventIDRange = HostReserveEventIDRange;
+	s_GraphicsVulkan.InterceptInitialization = HostInterceptInitialization;
+	s_GraphicsVulkan.InterceptVulkanAPI = HostInterceptVulkanAPI;
+	s_GraphicsVulkan.ConfigureEvent = HostConfigureEvent;
+	s_GraphicsVulkan.Instance = HostInstance;
+	s_GraphicsVulkan.CommandRecordingState = HostCommandRecordingState;
+	s_GraphicsVulkan.AccessTexture = HostAccessTexture;
+	s_Log.Log = HostLog;
+
+	IUnityInterfaces interfaces = {};
+	interfaces.GetInterface = HostGetInterface;
+	interfaces.RegisterInterface = HostRegisterInterface;
+	interfaces.GetInterfaceSplit = HostGetInterfaceSplit;
+	interfaces.RegisterInterfaceSplit = HostRegisterInterfaceSplit;
+
+	// Loaded before the device exists, like a plugin with "Load on startup"
+	plugin.UnityPluginLoad(&interfaces);
+
+	if (!CreateVulkanDevice(deviceIndex))
+		return 1;
+
+	s_Renderer = kUnityGfxRendererVulkan;
+	SendDeviceEvent(kUnityGfxDeviceEventInitialize);
+
+	const UnityRenderingEvent renderEvent = plugin.GetRenderEventFunc();
+	ReplayStats stats;
+	bool success = true;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int loop = 0; loop < loops && success; ++loop)
+	{
+		reader.Seek(firstRecord);
+		success = ReplayCapture(reader, plugin, renderEvent, &stats);
+	}
+	EndFrame();
+	vkDeviceWaitIdle(s_Instance.device);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (!success)
+		printf("Capture is truncated or corrupt, stopped at offset %zu\n", reader.GetOffset());
+
+	const double seconds = elapsed.count() - stats.cleanupSeconds;
+	printf("Replayed %llu frames, %llu render events in %.3f s (%d loops)\n", stats.frames, stats.renderEvents, seconds, loops);
+	if (seconds > 0.0)
+		printf("  %.1f frames/s, %.1f render events/s\n", stats.frames / seconds, stats.renderEvents / seconds);
+	if (stats.renderEvents > 0)
+		printf("  %.2f us per render event inside the plugin\n", stats.renderEventSeconds * 1e6 / stats.renderEvents);
+	if (stats.skippedTextures > 0)
+		printf("  %llu bindless textures skipped, Unity textures are not captured\n", stats.skippedTextures);
+
+	SendDeviceEvent(kUnityGfxDeviceEventShutdown);
+	plugin.UnityPluginUnload();
+
+	for (auto& renderPass : s_RenderPasses)
+		DestroyRenderPass(renderPass.second);
+	for (ReplayFrame& frame : s_Frames)
+	{
+		vkDestroyFence(s_Instance.device, frame.fence, nullptr);
+		vkDestroyCommandPool(s_Instance.device, frame.commandPool, nullptr);
+	}
+	vkDestroyDevice(s_Instance.device, nullptr);
+	vkDestroyInstance(s_Instance.instance, nullptr);
+	UnloadPluginLibrary(library);
+
+	return success ? 0 : 2;
+}
@@ -0,0 +1,74 @@
+using System;
+using System.Runtime.InteropServices;
+using Unity.Collections;
+using UnityEngine;
+using UnityEngine.Rendering;
+
+// Renders the plugin draws with its software rasterizer when there is no graphics device (batchmode -nographics)
+public class SoftwareFramebuffer : MonoBehaviour
+{
+    private const int DrawColoredTriangleEvent = 1;
+
+    public int width = 512;
+    public int height = 512;
+    public Color32 clearColor = new Color32(0, 0, 0, 255);
+    public bool logThroughput;
+
+    // RGBA32, updated every frame
+    public Texture2D Texture { get; private set; }
+
+    private byte[] _pixels;
+    private RenderEventFunc _renderEvent;
+
+    [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+    private delegate void RenderEventFunc(int eventId);
+
+    [DllImport("NativePluginSample")]
+    private static extern IntPtr GetRenderEventFunc();
+
+    [DllImport("NativePluginSample")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    private static extern bool SetSoftwareFramebufferSize(int width, int height);
+
+    [DllImport("NativePluginSample")]
+    private static extern void ClearSoftwareFramebuffer(uint rgba);
+
+    [DllImport("NativePluginSample")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    private static extern bool ReadSoftwareFramebuffer(byte[] pixels, int sizeInBytes);
+
+    [DllImport("NativePluginSample")]
+    private static extern double GetSoftwareFramebufferThroughput();
+
+    private void Start()
+    {
+        if (SystemInfo.graphicsDeviceType != GraphicsDeviceType.Null || !SetSoftwareFramebufferSize(width, height))
+        {
+            enabled = false;
+            return;
+        }
+
+        // Render events are not executed without a device, so call the plugin directly
+        _renderEvent = Marshal.GetDelegateForFunctionPointer<RenderEventFunc>(GetRenderEventFunc());
+        _pixels = new byte[width * height * 4];
+        Texture = new Texture2D(width, height, TextureFormat.RGBA32, false);
+    }
+
+    private void Update()
+    {
+        ClearSoftwareFramebuffer((uint)(clearColor.r | clearColor.g << 8 | clearColor.b << 16 | clearColor.a << 24));
+        _renderEvent(DrawColoredTriangleEvent);
+        if (!ReadSoftwareFramebuffer(_pixels, _pixels.Length))
+            return;
+
+        // The plugin writes rows top to bottom, Unity textures start at the bottom row
+        var data = Texture.GetPixelData<byte>(0);
+        var rowSize = width * 4;
+        for (var y = 0; y < height; ++y)
+            NativeArray<byte>.Copy(_pixels, y * rowSize, data, (height - 1 - y) * rowSize, rowSize);
+        Texture.Apply(false);
+
+        if (logThroughput)
+            Debug.Log($"Software rasterizer: {GetSoftwareFramebufferThroughput():F1} MP/s per core");
+    }
+}
@@ -1,18 +1,33 @@
 using System;
 using System.Runtime.InteropServices;
+using UnityEngine;
 using UnityEngine.Rendering;
 using UnityEngine.Rendering.Universal;
 
 public class TestRendererFeature : ScriptableRendererFeature
 {
+    public bool benchmarkCommandRecording;
+    // Records this many frames of plugin calls for PluginReplay, 0 disables
+    public int captureFrames;
+    public string captureFile = "PluginCapture.bin";
+    // Share of each GPU heap budget the plugin may use before streamable buffers are evicted
+    [Range(0, 1)] public float memoryBudgetFraction = 0.5f;
+    public bool logMemoryBudget;
+
     private TestRenderPass _testRenderPass;
     
     public override void Create()
     {
         _testRenderPass = new TestRenderPass
         {
-            renderPassEvent = RenderPassEvent.AfterRenderingOpaques
+            renderPassEvent = RenderPassEvent.AfterRenderingOpaques,
+            BenchmarkCommandRecording = benchmarkCommandRecording
         };
+        if (captureFrames > 0)
+            _testRenderPass.StartCapture(captureFile, captureFrames);
+        TestRenderPass.SetMemoryBudgetFraction(memoryBudgetFraction);
+        if (logMemoryBudget)
+            TestRenderPass.LogMemoryBudget();
     }
 
     public override void AddRenderPasses(ScriptableRenderer renderer, ref RenderingData renderingData)
@@ -23,21 +38,78 @@ public class TestRendererFeature : ScriptableRendererFeature
 
 public class TestRenderPass : ScriptableRenderPass
 {
+    private const int DrawColoredTriangleEvent = 1;
+    private const int BenchmarkCommandRecordingEvent = 2;
+    private const int UpdateBindlessTableEvent = 3;
+    private const int EndCaptureEvent = 4;
+
+    public bool BenchmarkCommandRecording;
+
+    private int _captureFramesLeft;
+
+    // Matches MemoryHeapBudget in RenderAPI.h
+    [StructLayout(LayoutKind.Sequential)]
+    private struct MemoryHeapBudget
+    {
+        public ulong size;
+        public ulong budget;
+        public ulong processUsage;
+        public ulong pluginUsage;
+        public ulong pluginLimit;
+        public int deviceLocal;
+        public int driverBudget;
+    }
+
     [DllImport("NativePluginSample")]
     private static extern void SetTimeFromUnity(float t);
     
     [DllImport("NativePluginSample")]
     private static extern IntPtr GetRenderEventFunc();
 
+    [DllImport("NativePluginSample")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    private static extern bool BeginPluginCapture(string path);
+
+    [DllImport("NativePluginSample")]
+    public static extern void SetMemoryBudgetFraction(float fraction);
+
+    [DllImport("NativePluginSample")]
+    private static extern int GetMemoryBudget([Out] MemoryHeapBudget[] heaps, int maxHeaps);
+
     public TestRenderPass()
     {
         SetTimeFromUnity(1.23f);
     }
+
+    public void StartCapture(string path, int frames)
+    {
+        if (BeginPluginCapture(path))
+            _captureFramesLeft = frames;
+    }
     
+    public static void LogMemoryBudget()
+    {
+        var heaps = new MemoryHeapBudget[16];
+        var heapCount = GetMemoryBudget(heaps, heaps.Length);
+        for (var i = 0; i < heapCount; ++i)
+        {
+            var heap = heaps[i];
+            Debug.Log($"Heap {i}{(heap.deviceLocal != 0 ? " (device local)" : "")}: plugin {heap.pluginUsage >> 20} MB of {heap.pluginLimit >> 20} MB, " +
+                      $"process {heap.processUsage >> 20} MB of {heap.budget >> 20} MB budget{(heap.driverBudget != 0 ? "" : " (estimated)")}, size {heap.size >> 20} MB");
+        }
+    }
+
     public override void Execute(ScriptableRenderContext context, ref RenderingData renderingData)
     {
         var cmd = CommandBufferPool.Get();
-        cmd.IssuePluginEvent(GetRenderEventFunc(), 1);
+        // Outside the render pass, applies bindless changes and recycles released slots once per frame
+        cmd.IssuePluginEvent(GetRenderEventFunc(), UpdateBindlessTableEvent);
+        cmd.IssuePluginEvent(GetRenderEventFunc(), DrawColoredTriangleEvent);
+        if (BenchmarkCommandRecording)
+            cmd.IssuePluginEvent(GetRenderEventFunc(), BenchmarkCommandRecordingEvent);
+        // Ended on the render thread, the main thread runs ahead and would cut off the last frames
+        if (_captureFramesLeft > 0 && --_captureFramesLeft == 0)
+            cmd.IssuePluginEvent(GetRenderEventFunc(), EndCaptureEvent);
         context.ExecuteCommandBuffer(cmd);
         CommandBufferPool.Release(cmd);
     }